@@ -0,0 +1,64 @@
+#include "benchmark_config_directory.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace config::benchmarks
+{
+BenchmarkConfigDirectory::BenchmarkConfigDirectory(const std::string& name, std::size_t keyCount)
+    : path{std::filesystem::temp_directory_path() / ("config-cxx-" + name)}
+{
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    std::ofstream file{path / "default.json"};
+
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Cannot create benchmark config file in: " + path.string());
+    }
+
+    // Keys are grouped in sections of 16 values to resemble a realistic nested config
+    file << "{\n";
+    for (std::size_t section = 0; section * 16 < keyCount; ++section)
+    {
+        file << (section == 0 ? "" : ",\n") << "  \"section" << section << "\": {";
+        for (std::size_t index = 0; index < 16 && section * 16 + index < keyCount; ++index)
+        {
+            file << (index == 0 ? "" : ",") << "\n    \"key" << index << "\": " << section * 16 + index;
+            keys.push_back("section" + std::to_string(section) + ".key" + std::to_string(index));
+        }
+        file << "\n  }";
+    }
+    file << "\n}\n";
+
+    setEnvironmentVariable("CXX_ENV", "default");
+    setEnvironmentVariable("CXX_CONFIG_DIR", path.string());
+}
+
+BenchmarkConfigDirectory::~BenchmarkConfigDirectory()
+{
+    std::error_code errorCode;
+    std::filesystem::remove_all(path, errorCode);
+}
+
+const std::filesystem::path& BenchmarkConfigDirectory::getPath() const
+{
+    return path;
+}
+
+const std::vector<std::string>& BenchmarkConfigDirectory::getKeys() const
+{
+    return keys;
+}
+
+void BenchmarkConfigDirectory::setEnvironmentVariable(const std::string& envName, const std::string& envValue)
+{
+#if defined(_WIN32)
+    _putenv_s(envName.c_str(), envValue.c_str());
+#else
+    setenv(envName.c_str(), envValue.c_str(), 1);
+#endif
+}
+}
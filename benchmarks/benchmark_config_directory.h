@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace config::benchmarks
+{
+/**
+ * Temporary config directory with a generated default.json, pointed to by CXX_CONFIG_DIR for its lifetime.
+ */
+class BenchmarkConfigDirectory
+{
+public:
+    BenchmarkConfigDirectory(const std::string& name, std::size_t keyCount);
+    ~BenchmarkConfigDirectory();
+
+    BenchmarkConfigDirectory(const BenchmarkConfigDirectory&) = delete;
+    BenchmarkConfigDirectory& operator=(const BenchmarkConfigDirectory&) = delete;
+
+    const std::filesystem::path& getPath() const;
+    const std::vector<std::string>& getKeys() const;
+
+    static void setEnvironmentVariable(const std::string& envName, const std::string& envValue);
+
+private:
+    std::filesystem::path path;
+    std::vector<std::string> keys;
+};
+}
@@ -0,0 +1,67 @@
+#include "benchmark_perf_counter.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace config::benchmarks
+{
+CacheMissCounter::CacheMissCounter()
+{
+#if defined(__linux__)
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    fileDescriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+}
+
+CacheMissCounter::~CacheMissCounter()
+{
+#if defined(__linux__)
+    if (fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+    }
+#endif
+}
+
+void CacheMissCounter::start()
+{
+#if defined(__linux__)
+    if (fileDescriptor >= 0)
+    {
+        ioctl(fileDescriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+std::optional<std::uint64_t> CacheMissCounter::stop()
+{
+#if defined(__linux__)
+    if (fileDescriptor >= 0)
+    {
+        ioctl(fileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+        std::uint64_t count = 0;
+        if (read(fileDescriptor, &count, sizeof(count)) == sizeof(count))
+        {
+            return count;
+        }
+    }
+#endif
+
+    return std::nullopt;
+}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace config::benchmarks
+{
+/**
+ * Hardware cache miss counter of the calling thread.
+ *
+ * Uses perf_event_open on Linux, on other platforms or without permission to use perf events the counter is
+ * unavailable and read() returns std::nullopt.
+ */
+class CacheMissCounter
+{
+public:
+    CacheMissCounter();
+    ~CacheMissCounter();
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    void start();
+    std::optional<std::uint64_t> stop();
+
+private:
+    int fileDescriptor = -1;
+};
+}
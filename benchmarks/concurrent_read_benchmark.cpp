@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "benchmark_config_directory.h"
+#include "config-cxx/config.h"
+
+using namespace config;
+using namespace config::benchmarks;
+
+namespace
+{
+constexpr std::size_t keyCount = 1024;
+constexpr auto measurementDuration = std::chrono::milliseconds{500};
+
+double measureReadsPerSecond(Config& config, const std::vector<std::string>& keys, unsigned threadCount)
+{
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::vector<std::uint64_t> readsPerThread(threadCount * 8, 0);
+    std::vector<std::thread> threads;
+
+    for (unsigned threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+    {
+        threads.emplace_back(
+            [&, threadIndex]
+            {
+                std::uint64_t reads = 0;
+                std::uint64_t checksum = 0;
+                std::size_t keyIndex = threadIndex * 97;
+
+                while (!start.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (int batch = 0; batch < 64; ++batch)
+                    {
+                        const auto& key = keys[keyIndex++ % keys.size()];
+                        checksum += static_cast<std::uint64_t>(config.get<int>(key));
+                        checksum += config.has(key) ? 1 : 0;
+                        reads += 2;
+                    }
+                }
+
+                // Padded slots keep the per-thread counters on separate cache lines
+                readsPerThread[threadIndex * 8] = reads + (checksum == 0 ? 1 : 0);
+            });
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(measurementDuration);
+    stop.store(true, std::memory_order_relaxed);
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::uint64_t totalReads = 0;
+    for (unsigned threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+    {
+        totalReads += readsPerThread[threadIndex * 8];
+    }
+
+    return static_cast<double>(totalReads) / elapsed;
+}
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkConfigDirectory configDirectory{"concurrent-read-benchmark", keyCount};
+
+    Config config;
+
+    // Load the configuration up front so that only the read path is measured
+    config.has(configDirectory.getKeys().front());
+
+    // Thread count defaults to the number of hardware threads and can be overridden with the first argument
+    const auto maxThreads = argc > 1 ? static_cast<unsigned>(std::max(1, std::atoi(argv[1]))) :
+                                       std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threadCount = 1; threadCount < maxThreads; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "Concurrent Config::get<int>/has throughput (" << keyCount << " keys)\n";
+    std::cout << std::setw(8) << "threads" << std::setw(18) << "reads/s" << std::setw(12) << "speedup"
+              << std::setw(14) << "efficiency" << "\n";
+
+    double singleThreadReadsPerSecond = 0;
+
+    for (const auto threadCount : threadCounts)
+    {
+        const auto readsPerSecond = measureReadsPerSecond(config, configDirectory.getKeys(), threadCount);
+
+        if (threadCount == 1)
+        {
+            singleThreadReadsPerSecond = readsPerSecond;
+        }
+
+        const auto speedup = readsPerSecond / singleThreadReadsPerSecond;
+
+        std::cout << std::setw(8) << threadCount << std::setw(18) << std::fixed << std::setprecision(0)
+                  << readsPerSecond << std::setw(11) << std::setprecision(2) << speedup << "x" << std::setw(13)
+                  << std::setprecision(0) << speedup / threadCount * 100 << "%\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark_perf_counter.h"
+#include "config_store.h"
+
+using namespace config;
+using namespace config::benchmarks;
+
+namespace
+{
+constexpr std::size_t lookupCount = 2'000'000;
+
+struct Measurement
+{
+    double nanosecondsPerLookup;
+    std::optional<double> cacheMissesPerLookup;
+};
+
+template <typename Lookup>
+Measurement measure(const std::vector<const std::string*>& lookupKeys, Lookup lookup)
+{
+    CacheMissCounter cacheMissCounter;
+    std::int64_t checksum = 0;
+
+    cacheMissCounter.start();
+    const auto begin = std::chrono::steady_clock::now();
+
+    for (const auto& key : lookupKeys)
+    {
+        checksum += lookup(*key);
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    const auto cacheMisses = cacheMissCounter.stop();
+
+    if (checksum == 0)
+    {
+        std::cout << "";
+    }
+
+    const auto lookups = static_cast<double>(lookupKeys.size());
+
+    return {elapsed / lookups, cacheMisses ? std::optional<double>{static_cast<double>(*cacheMisses) / lookups} :
+                                             std::nullopt};
+}
+
+void printMeasurement(const std::string& name, std::size_t keyCount, const Measurement& measurement)
+{
+    std::cout << std::setw(10) << keyCount << std::setw(22) << name << std::setw(14) << std::fixed
+              << std::setprecision(1) << measurement.nanosecondsPerLookup;
+
+    if (measurement.cacheMissesPerLookup)
+    {
+        std::cout << std::setw(18) << std::setprecision(2) << *measurement.cacheMissesPerLookup;
+    }
+    else
+    {
+        std::cout << std::setw(18) << "n/a";
+    }
+
+    std::cout << "\n";
+}
+
+void runBenchmark(std::size_t keyCount)
+{
+    std::unordered_map<std::string, ConfigValue> values;
+    std::vector<std::string> keys;
+    keys.reserve(keyCount);
+
+    for (std::size_t index = 0; index < keyCount; ++index)
+    {
+        keys.push_back("service" + std::to_string(index / 64) + ".settings.option" + std::to_string(index % 64));
+        values[keys.back()] = static_cast<int>(index);
+    }
+
+    const ConfigStore store{values};
+
+    std::mt19937_64 generator{42};
+    std::uniform_int_distribution<std::size_t> distribution{0, keyCount - 1};
+
+    std::vector<const std::string*> lookupKeys;
+    lookupKeys.reserve(lookupCount);
+
+    for (std::size_t index = 0; index < lookupCount; ++index)
+    {
+        lookupKeys.push_back(&keys[distribution(generator)]);
+    }
+
+    // Both lookups hash the full key path at runtime, so only the table layout differs
+    const auto mapMeasurement =
+        measure(lookupKeys, [&values](const std::string& key) { return std::get<int>(values.find(key)->second); });
+
+    const auto storeMeasurement =
+        measure(lookupKeys, [&store](const std::string& key) { return store.find(key)->asInt(); });
+
+    printMeasurement("std::unordered_map", keyCount, mapMeasurement);
+    printMeasurement("ConfigStore", keyCount, storeMeasurement);
+}
+}
+
+int main()
+{
+    std::cout << "Random exact key lookups (" << lookupCount << " per run)\n";
+    std::cout << std::setw(10) << "keys" << std::setw(22) << "store" << std::setw(14) << "ns/lookup"
+              << std::setw(18) << "misses/lookup" << "\n";
+
+    for (const auto keyCount : {std::size_t{1'000}, std::size_t{100'000}, std::size_t{1'000'000}})
+    {
+        runBenchmark(keyCount);
+    }
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compact_value.h"
+#include "config_store.h"
+
+using namespace config;
+
+namespace
+{
+// Each allocation is prefixed with its size so that frees can be subtracted and only live bytes are reported.
+constexpr std::size_t allocationHeaderSize = alignof(std::max_align_t);
+
+std::atomic<std::size_t> liveBytes{0};
+std::atomic<std::size_t> allocationCount{0};
+
+struct Measurement
+{
+    std::size_t liveBytes;
+    std::size_t allocations;
+};
+
+std::unordered_map<std::string, ConfigValue> createValues(std::size_t keyCount)
+{
+    std::unordered_map<std::string, ConfigValue> values;
+
+    for (std::size_t index = 0; index < keyCount; ++index)
+    {
+        const auto prefix = "section" + std::to_string(index / 16) + ".key" + std::to_string(index % 16);
+
+        switch (index % 4)
+        {
+        case 0:
+            values.emplace(prefix, static_cast<int>(index));
+            break;
+        case 1:
+            values.emplace(prefix, index % 2 == 0);
+            break;
+        case 2:
+            values.emplace(prefix, "value-" + std::to_string(index % 64));
+            break;
+        default:
+            values.emplace(prefix, std::vector<std::string>{"first", "second"});
+            break;
+        }
+    }
+
+    return values;
+}
+
+void* allocate(std::size_t size, std::size_t alignment)
+{
+    const auto headerSize = std::max(alignment, allocationHeaderSize);
+    const auto allocationSize = (size + 2 * headerSize - 1) / headerSize * headerSize;
+
+    auto* memory = static_cast<unsigned char*>(std::aligned_alloc(headerSize, allocationSize));
+
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    std::memcpy(memory, &size, sizeof(size));
+    liveBytes += size;
+    ++allocationCount;
+
+    return memory + headerSize;
+}
+
+void deallocate(void* memory, std::size_t alignment) noexcept
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+
+    auto* allocation = static_cast<unsigned char*>(memory) - std::max(alignment, allocationHeaderSize);
+
+    std::size_t size = 0;
+    std::memcpy(&size, allocation, sizeof(size));
+    liveBytes -= size;
+
+    std::free(allocation);
+}
+
+template <typename Build>
+Measurement measure(Build build)
+{
+    const auto bytesBefore = liveBytes.load();
+    const auto allocationsBefore = allocationCount.load();
+    const auto container = build();
+
+    return {liveBytes.load() - bytesBefore, allocationCount.load() - allocationsBefore};
+}
+
+void printMeasurement(const std::string& name, std::size_t keyCount, const Measurement& measurement)
+{
+    std::cout << std::setw(10) << keyCount << std::setw(22) << name << std::setw(15) << std::fixed
+              << std::setprecision(1) << static_cast<double>(measurement.liveBytes) / static_cast<double>(keyCount)
+              << std::setw(15) << measurement.allocations << "\n";
+}
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    return allocate(size, allocationHeaderSize);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+    deallocate(memory, allocationHeaderSize);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    deallocate(memory, allocationHeaderSize);
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept
+{
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+int main()
+{
+    std::cout << "sizeof(ConfigValue)  = " << sizeof(ConfigValue) << " bytes\n";
+    std::cout << "sizeof(CompactValue) = " << sizeof(CompactValue) << " bytes\n\n";
+    std::cout << std::setw(10) << "keys" << std::setw(22) << "container" << std::setw(15) << "bytes/key"
+              << std::setw(15) << "allocations" << "\n";
+
+    for (const std::size_t keyCount : {1'000, 100'000})
+    {
+        const auto values = createValues(keyCount);
+
+        auto parsedValues = values;
+
+        // The copy passed to the store is released when it is frozen, so only the store remains in the live bytes.
+        // Allocations are counted for a store taking over already parsed values, as Config does.
+        const auto storeBytes = measure([&] { return std::make_unique<ConfigStore>(values); }).liveBytes;
+        const auto storeAllocations =
+            measure([&] { return std::make_unique<ConfigStore>(std::move(parsedValues)); }).allocations;
+
+        printMeasurement("std::unordered_map", keyCount, measure([&] { return values; }));
+        printMeasurement("ConfigStore", keyCount, {storeBytes, storeAllocations});
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "benchmark_config_directory.h"
+#include "config-cxx/config.h"
+
+using namespace config;
+using namespace config::benchmarks;
+
+namespace
+{
+constexpr std::size_t keysPerFile = 4096;
+constexpr int repetitions = 5;
+
+// Files rotate through JSON, YAML and XML, every file holds its own sections of keysPerFile values
+void writeConfigFile(const std::filesystem::path& directory, std::size_t fileIndex)
+{
+    const auto name = "layer" + std::to_string(fileIndex);
+
+    switch (fileIndex % 3)
+    {
+    case 0:
+    {
+        std::ofstream file{directory / (name + ".json")};
+        file << "{\"" << name << "\": {";
+        for (std::size_t index = 0; index < keysPerFile; ++index)
+        {
+            file << (index == 0 ? "" : ",") << "\n  \"section" << index / 16 << "\": {\"key" << index % 16
+                 << "\": \"value" << index << "\"}";
+        }
+        file << "\n}}\n";
+        break;
+    }
+    case 1:
+    {
+        std::ofstream file{directory / (name + ".yaml")};
+        file << name << ":\n";
+        for (std::size_t index = 0; index < keysPerFile; ++index)
+        {
+            if (index % 16 == 0)
+            {
+                file << "    section" << index / 16 << ":\n";
+            }
+            file << "        key" << index % 16 << ": value" << index << "\n";
+        }
+        break;
+    }
+    default:
+    {
+        std::ofstream file{directory / (name + ".xml")};
+        file << "<configuration><" << name << ">\n";
+        for (std::size_t index = 0; index < keysPerFile; index += 16)
+        {
+            file << "  <section" << index / 16 << ">";
+            for (std::size_t key = 0; key < 16; ++key)
+            {
+                file << "<key" << key << ">value" << index + key << "</key" << key << ">";
+            }
+            file << "</section" << index / 16 << ">\n";
+        }
+        file << "</" << name << "></configuration>\n";
+        break;
+    }
+    }
+}
+
+double measureLoadMilliseconds()
+{
+    double bestMilliseconds = 0;
+
+    for (int repetition = 0; repetition < repetitions; ++repetition)
+    {
+        // A new config loads the files again once the previous one released the shared store
+        Config config;
+
+        const auto begin = std::chrono::steady_clock::now();
+        config.load();
+        const auto milliseconds =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        bestMilliseconds = repetition == 0 ? milliseconds : std::min(bestMilliseconds, milliseconds);
+    }
+
+    return bestMilliseconds;
+}
+}
+
+int main(int argc, char** argv)
+{
+    // Maximum file count defaults to 32 and can be overridden with the first argument
+    const auto maxFiles = argc > 1 ? static_cast<std::size_t>(std::max(1, std::atoi(argv[1]))) : std::size_t{32};
+
+    BenchmarkConfigDirectory configDirectory{"startup-benchmark", 16};
+    const auto cacheDirectory = configDirectory.getPath().parent_path() / "startup-benchmark-cache";
+
+    std::cout << "Config::load() time by file count (" << keysPerFile << " keys per file, best of " << repetitions
+              << ", " << std::max(1u, std::thread::hardware_concurrency()) << " hardware threads)\n";
+    std::cout << std::setw(8) << "files" << std::setw(16) << "serial ms" << std::setw(16) << "parallel ms"
+              << std::setw(12) << "speedup" << std::setw(16) << "cached ms" << "\n";
+
+    std::size_t writtenFiles = 0;
+
+    for (std::size_t fileCount = 1; fileCount <= maxFiles; fileCount *= 2)
+    {
+        for (; writtenFiles < fileCount; ++writtenFiles)
+        {
+            writeConfigFile(configDirectory.getPath(), writtenFiles);
+        }
+
+        BenchmarkConfigDirectory::setEnvironmentVariable("CXX_CONFIG_LOAD_THREADS", "1");
+        const auto serialMilliseconds = measureLoadMilliseconds();
+
+        BenchmarkConfigDirectory::setEnvironmentVariable("CXX_CONFIG_LOAD_THREADS", "");
+        const auto parallelMilliseconds = measureLoadMilliseconds();
+
+        // The first load writes the cache, the following ones read the values from it without parsing any file
+        BenchmarkConfigDirectory::setEnvironmentVariable("CXX_CONFIG_CACHE_DIR", cacheDirectory.string());
+        const auto cachedMilliseconds = measureLoadMilliseconds();
+        BenchmarkConfigDirectory::setEnvironmentVariable("CXX_CONFIG_CACHE_DIR", "");
+
+        std::cout << std::setw(8) << fileCount << std::setw(16) << std::fixed << std::setprecision(2)
+                  << serialMilliseconds << std::setw(16) << parallelMilliseconds << std::setw(11)
+                  << serialMilliseconds / parallelMilliseconds << "x" << std::setw(16) << cachedMilliseconds << "\n";
+    }
+
+    std::filesystem::remove_all(cacheDirectory);
+
+    return 0;
+}
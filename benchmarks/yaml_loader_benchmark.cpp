@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "benchmark_config_directory.h"
+#include "yaml-cpp/yaml.h"
+#include "yaml_config_loader.h"
+
+using namespace config;
+using namespace config::benchmarks;
+
+namespace
+{
+constexpr int repetitions = 5;
+
+// Sections mix strings, numbers, booleans, scalar lists and lists of maps, 16 lines per section
+std::size_t writeYamlFile(const std::filesystem::path& filePath, std::size_t lineCount)
+{
+    std::ofstream file{filePath};
+    std::size_t writtenLines = 0;
+
+    for (std::size_t section = 0; writtenLines < lineCount; ++section)
+    {
+        file << "section" << section << ":\n"
+             << "    name: service-" << section << "\n"
+             << "    enabled: " << (section % 2 == 0 ? "true" : "false") << "\n"
+             << "    port: " << 1024 + section % 50000 << "\n"
+             << "    ratio: " << section % 100 << ".25\n"
+             << "    url: https://example.com/api/v" << section % 7 << "/resource\n"
+             << "    tags: [alpha, beta, gamma]\n"
+             << "    retries: [1, 2, 4, 8]\n"
+             << "    database:\n"
+             << "        host: db" << section << ".internal\n"
+             << "        user: app_user\n"
+             << "        timeout: 30\n"
+             << "    endpoints:\n"
+             << "        - path: /health\n"
+             << "          method: GET\n"
+             << "        - path: /items\n"
+             << "          method: POST\n";
+        writtenLines += 16;
+    }
+
+    return writtenLines;
+}
+
+template <typename Load>
+double measureBestMilliseconds(Load load)
+{
+    double bestMilliseconds = 0;
+
+    for (int repetition = 0; repetition < repetitions; ++repetition)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        load();
+        const auto milliseconds =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        bestMilliseconds = repetition == 0 ? milliseconds : std::min(bestMilliseconds, milliseconds);
+    }
+
+    return bestMilliseconds;
+}
+}
+
+int main(int argc, char** argv)
+{
+    // Line count defaults to 40000 and can be overridden with the first argument
+    const auto lineCount = argc > 1 ? static_cast<std::size_t>(std::max(16, std::atoi(argv[1]))) : std::size_t{40000};
+
+    BenchmarkConfigDirectory configDirectory{"yaml-loader-benchmark", 16};
+    const auto filePath = configDirectory.getPath() / "large.yaml";
+    const auto writtenLines = writeYamlFile(filePath, lineCount);
+
+    std::size_t keyCount = 0;
+
+    const auto loaderMilliseconds = measureBestMilliseconds(
+        [&]
+        {
+            std::unordered_map<std::string, ConfigValue> configValues;
+            YamlConfigLoader::loadConfigFile(filePath, configValues);
+            keyCount = configValues.size();
+        });
+
+    // Reference point: building the yaml-cpp node tree alone, without flattening or typing any value
+    const auto nodeTreeMilliseconds = measureBestMilliseconds([&] { YAML::LoadFile(filePath.string()); });
+
+    std::cout << "YAML load time for " << writtenLines << " lines, " << keyCount << " keys (best of " << repetitions
+              << ")\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(24) << "YamlConfigLoader ms" << std::setw(12) << loaderMilliseconds << "\n";
+    std::cout << std::setw(24) << "YAML::LoadFile ms" << std::setw(12) << nodeTreeMilliseconds << "\n";
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+# config_cxx_embed(<target> <config directory> <CXX_ENV> [NAME <name>])
+#
+# Merges the config files of the directory for CXX_ENV at build time, with the same precedence as Config does at
+# runtime, and adds the generated header config-cxx-embedded/<name>.h to the target. The header defines
+# config::embedded::<name>, a constexpr table of the merged values that config::Config loads without reading or
+# parsing any file. NAME defaults to embeddedConfig.
+#
+# Custom environment variable files are not resolved at build time, their keys are read from the environment when the
+# config is loaded with config::EmbeddedOverrides::Environment or FilesAndEnvironment.
+#
+# When cross compiling, set CONFIG_CXX_EMBED_EXECUTABLE to a config-cxx-embed built for the build machine.
+function(config_cxx_embed target directory environment)
+    cmake_parse_arguments(PARSE_ARGV 3 CONFIG_CXX_EMBED "" "NAME" "")
+
+    if (NOT CONFIG_CXX_EMBED_NAME)
+        set(CONFIG_CXX_EMBED_NAME embeddedConfig)
+    endif ()
+
+    get_filename_component(directory "${directory}" ABSOLUTE)
+
+    set(output_directory "${CMAKE_CURRENT_BINARY_DIR}/${target}-embedded")
+    set(output "${output_directory}/config-cxx-embedded/${CONFIG_CXX_EMBED_NAME}.h")
+
+    if (CONFIG_CXX_EMBED_EXECUTABLE)
+        set(generator "${CONFIG_CXX_EMBED_EXECUTABLE}")
+    else ()
+        set(generator config-cxx-embed)
+    endif ()
+
+    # Adding or removing a config file reconfigures, editing one regenerates the header
+    file(GLOB config_files CONFIGURE_DEPENDS "${directory}/*")
+
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND ${generator} "${directory}" "${environment}" "${CONFIG_CXX_EMBED_NAME}" "${output}"
+        DEPENDS ${generator} ${config_files}
+        COMMENT "Embedding config directory ${directory} for CXX_ENV=${environment}"
+        VERBATIM)
+
+    target_sources(${target} PRIVATE "${output}")
+    target_include_directories(${target} PRIVATE "${output_directory}")
+endfunction()
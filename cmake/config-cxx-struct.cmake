@@ -0,0 +1,41 @@
+# config_cxx_struct(<target> <schema file> NAME <struct name> [NAMESPACE <namespace>])
+#
+# Generates the header config-cxx-generated/<struct name>.h at build time and adds it to the target. The header defines
+# a struct with one member per key of the schema file, nested structs for objects and vectors of structs for arrays of
+# objects. The schema is a config file in any supported format, usually default.json, whose values give the member
+# types. <struct name>::load(config) reads every member from a loaded config::Config once. NAMESPACE defaults to
+# config::generated.
+#
+# When cross compiling, set CONFIG_CXX_STRUCT_EXECUTABLE to a config-cxx-struct built for the build machine.
+function(config_cxx_struct target schema)
+    cmake_parse_arguments(PARSE_ARGV 2 CONFIG_CXX_STRUCT "" "NAME;NAMESPACE" "")
+
+    if (NOT CONFIG_CXX_STRUCT_NAME)
+        message(FATAL_ERROR "config_cxx_struct() requires the NAME of the generated struct")
+    endif ()
+
+    if (NOT CONFIG_CXX_STRUCT_NAMESPACE)
+        set(CONFIG_CXX_STRUCT_NAMESPACE config::generated)
+    endif ()
+
+    get_filename_component(schema "${schema}" ABSOLUTE)
+
+    set(output_directory "${CMAKE_CURRENT_BINARY_DIR}/${target}-generated")
+    set(output "${output_directory}/config-cxx-generated/${CONFIG_CXX_STRUCT_NAME}.h")
+
+    if (CONFIG_CXX_STRUCT_EXECUTABLE)
+        set(generator "${CONFIG_CXX_STRUCT_EXECUTABLE}")
+    else ()
+        set(generator config-cxx-struct)
+    endif ()
+
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND ${generator} "${schema}" "${CONFIG_CXX_STRUCT_NAME}" "${CONFIG_CXX_STRUCT_NAMESPACE}" "${output}"
+        DEPENDS ${generator} "${schema}"
+        COMMENT "Generating config struct ${CONFIG_CXX_STRUCT_NAME} from ${schema}"
+        VERBATIM)
+
+    target_sources(${target} PRIVATE "${output}")
+    target_include_directories(${target} PRIVATE "${output_directory}")
+endfunction()
@@ -1,16 +1,32 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace config
 {
-using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>>;
+using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>,
+                                 std::vector<int>, std::vector<double>, std::vector<bool>>;
 
 enum class LogLevel
 {
@@ -22,9 +38,712 @@ enum class LogLevel
 
 using LogCallback = std::function<void(LogLevel, const std::string&)>;
 
+class CompactValue;
+class Config;
+class ConfigElements;
+class ConfigStore;
+
+/**
+ * @brief Non-owning config key path together with its hash.
+ *
+ * Accessors take a KeyPath, so std::string, std::string_view and string literals can be passed without allocating.
+ * Keys created with the _ck literal have their hash computed at compile time, so looking them up never rehashes the
+ * path. A KeyPath does not own the path, it must not outlive the string it was created from.
+ */
+class KeyPath
+{
+public:
+    constexpr KeyPath(const char* path) : KeyPath(std::string_view{path}) {}
+    constexpr KeyPath(std::string_view path) : path{path}, hash{hashPath(path)} {}
+    KeyPath(const std::string& path) : KeyPath(std::string_view{path}) {}
+
+    constexpr std::string_view getPath() const
+    {
+        return path;
+    }
+
+    constexpr std::uint64_t getHash() const
+    {
+        return hash;
+    }
+
+    /**
+     * @brief Hash of a key path, the same function is used by the config store.
+     *
+     * Reads the path eight bytes at a time and mixes every word with a multiply and shift, the result is finalized
+     * with the SplitMix64 finalizer.
+     */
+    static constexpr std::uint64_t hashPath(std::string_view path)
+    {
+        std::uint64_t result = 0x9e3779b97f4a7c15ull ^ path.size();
+        std::size_t offset = 0;
+
+        for (; offset + 8 <= path.size(); offset += 8)
+        {
+            result = mixWord(result ^ readWord(path, offset, 8));
+        }
+
+        // The tail is read as the last eight bytes of the path, overlapping the previous word
+        result = mixWord(result ^ (path.size() >= 8 ? readWord(path, path.size() - 8, 8) :
+                                                      readWord(path, 0, path.size())));
+
+        result ^= result >> 30;
+        result *= 0xbf58476d1ce4e5b9ull;
+        result ^= result >> 27;
+        result *= 0x94d049bb133111ebull;
+        result ^= result >> 31;
+
+        return result;
+    }
+
+private:
+    static constexpr std::uint64_t readWord(std::string_view path, std::size_t offset, std::size_t size)
+    {
+        std::uint64_t word = 0;
+
+        if (!std::is_constant_evaluated() && std::endian::native == std::endian::little && size == 8)
+        {
+            std::memcpy(&word, path.data() + offset, 8);
+            return word;
+        }
+
+        // Little endian assembly of the bytes, gives the same result as the load above on little endian platforms
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            word |= static_cast<std::uint64_t>(static_cast<unsigned char>(path[offset + index])) << (index * 8);
+        }
+
+        return word;
+    }
+
+    static constexpr std::uint64_t mixWord(std::uint64_t word)
+    {
+        word *= 0xff51afd7ed558ccdull;
+        return word ^ (word >> 32);
+    }
+
+    std::string_view path;
+    std::uint64_t hash;
+};
+
+namespace literals
+{
+/**
+ * @brief Config key literal with the hash of the path computed at compile time.
+ *
+ * @code
+ * using namespace config::literals;
+ *
+ * Config().get<int>("db.pool.max"_ck) // 10
+ * @endcode
+ */
+consteval KeyPath operator""_ck(const char* path, std::size_t size)
+{
+    return KeyPath{std::string_view{path, size}};
+}
+}
+
+/**
+ * @brief Type independent part of ConfigKey.
+ *
+ * Every declared key handle alive in the program is registered, so that all of them can be resolved and validated in
+ * one pass with Config::resolveKeys(). Handles returned by Config::handle() and their copies are not registered, they
+ * stay resolved against the config that returned them. Resolve state is mutable, so handles may be declared const.
+ */
+class ConfigKeyBase
+{
+public:
+    const std::string& getKeyPath() const;
+    bool isResolved() const;
+
+protected:
+    ConfigKeyBase(std::string keyPath, bool registered);
+    ConfigKeyBase(const ConfigKeyBase& other);
+    ConfigKeyBase& operator=(const ConfigKeyBase& other);
+    virtual ~ConfigKeyBase();
+
+    virtual void resolve(Config& config) const = 0;
+    [[noreturn]] void throwNotResolved() const;
+
+    std::string keyPath;
+    mutable bool resolved = false;
+
+private:
+    friend class Config;
+
+    static void resolveAll(Config& config);
+
+    bool registered;
+    mutable const ConfigKeyBase* previous = nullptr;
+    mutable const ConfigKeyBase* next = nullptr;
+};
+
+/**
+ * @brief Handle to a config key whose lookup and type conversion are done once.
+ *
+ * Reading a resolved handle does not hash the key path, search the store or convert the value.
+ * Handles are resolved by Config::handle() or, when declared, by Config::resolveKeys().
+ * Resolving must not run concurrently with reads of the same handle.
+ *
+ * @code
+ * const config::ConfigKey<int> dbPort{"db.port"};
+ *
+ * config.resolveKeys();
+ * dbPort.get() // 3306
+ * @endcode
+ */
+template <typename T>
+class ConfigKey : public ConfigKeyBase
+{
+public:
+    explicit ConfigKey(std::string keyPath) : ConfigKeyBase(std::move(keyPath), true) {}
+
+    const T& get() const
+    {
+        if (!resolved)
+        {
+            throwNotResolved();
+        }
+
+        return *value;
+    }
+
+    const T& operator*() const
+    {
+        return get();
+    }
+
+    const T* operator->() const
+    {
+        return &get();
+    }
+
+protected:
+    void resolve(Config& config) const override;
+
+private:
+    friend class Config;
+
+    ConfigKey(std::string keyPath, bool registered) : ConfigKeyBase(std::move(keyPath), registered) {}
+
+    mutable std::optional<T> value;
+};
+
+/**
+ * @brief Range over the names of the keys directly nested under a view, returned by ConfigView::children().
+ *
+ * Names are views of the stored keys in key order. The iterator skips the subtree of a child with one binary search
+ * over the sorted key index, nothing is allocated while iterating.
+ */
+class ConfigChildren
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        Iterator() = default;
+
+        std::string_view operator*() const;
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const
+        {
+            return position == other.position;
+        }
+
+    private:
+        friend class ConfigChildren;
+
+        Iterator(const ConfigChildren& children, std::size_t position);
+
+        std::size_t findChildEnd() const;
+
+        const ConfigChildren* children = nullptr;
+        std::size_t position = 0;
+        std::size_t childEnd = 0;
+    };
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    friend class ConfigView;
+
+    ConfigChildren(const ConfigStore& store, std::size_t first, std::size_t last, std::size_t prefixSize);
+
+    const ConfigStore* store;
+    std::size_t first;
+    std::size_t last;
+    std::size_t prefixSize;
+};
+
+/**
+ * @brief Read-only view of the keys nested under a key path, returned by Config::view() and Config::elements().
+ *
+ * A view holds the range of its keys in the sorted key index, so keys are looked up relative to it without building
+ * their full key path. A view refers to the values of the config it was created from and must not outlive it.
+ *
+ * @code
+ * const auto billing = config.view("services.billing");
+ *
+ * billing.get<int>("timeout") // 30, read from "services.billing.timeout"
+ * billing.view("retry").get<int>("max") // 5
+ *
+ * for (const auto& server : config.elements("servers"))
+ * {
+ *     server.get<int>("port") // 8080
+ * }
+ * @endcode
+ */
+class ConfigView
+{
+public:
+    template <typename T>
+    T get(KeyPath keyPath) const;
+
+    template <typename T>
+    std::optional<T> getOptional(KeyPath keyPath) const;
+
+    bool has(KeyPath keyPath) const;
+
+    /**
+     * @brief View of the keys nested under a path relative to this view, written with dots as "retry.policy".
+     *
+     * @throws std::runtime_error if no keys are nested under the path.
+     */
+    ConfigView view(KeyPath keyPath) const;
+
+    /**
+     * @brief Names of the keys directly nested under the view, in key order.
+     *
+     * @code
+     * for (const auto name : config.view("services").children())
+     * {
+     *     name // "billing", "shipping"
+     * }
+     * @endcode
+     */
+    ConfigChildren children() const;
+
+    /**
+     * @brief Full path of the viewed keys, for example "servers.1", empty for a view of the whole config.
+     */
+    std::string_view getKeyPath() const;
+
+private:
+    friend class Config;
+    friend class ConfigElements;
+
+    ConfigView(const Config& config, const ConfigStore& store, std::size_t first, std::size_t last,
+               std::size_t prefixSize);
+
+    std::optional<CompactValue> findValue(std::string_view keyPath) const;
+    // Keys nested under a relative key path without brackets, std::nullopt if there are none
+    std::optional<ConfigView> findView(std::string_view keyPath) const;
+    std::optional<ConfigElements> findElements(std::string_view keyPath) const;
+
+    const Config* config;
+    const ConfigStore* store;
+    std::size_t first;
+    std::size_t last;
+    std::size_t prefixSize;
+};
+
+/**
+ * @brief Range over the elements of an array of objects, returned by Config::elements().
+ *
+ * The iterator steps from one element to the next with a binary search over the sorted key index, no key strings are
+ * built while iterating.
+ */
+class ConfigElements
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ConfigView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = ConfigView;
+
+        Iterator() = default;
+
+        ConfigView operator*() const;
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const
+        {
+            return position == other.position;
+        }
+
+    private:
+        friend class ConfigElements;
+
+        Iterator(const ConfigElements& elements, std::size_t position);
+
+        std::size_t findElementEnd() const;
+        std::string_view getIndex() const;
+
+        const ConfigElements* elements = nullptr;
+        std::size_t position = 0;
+        std::size_t elementEnd = 0;
+    };
+
+    Iterator begin() const;
+    Iterator end() const;
+    std::size_t size() const;
+
+private:
+    friend class Config;
+    friend class ConfigView;
+
+    ConfigElements(const Config& config, const ConfigStore& store, std::size_t first, std::size_t last,
+                   std::size_t prefixSize, std::size_t elementCount);
+
+    const Config* config;
+    const ConfigStore* store;
+    std::size_t first;
+    std::size_t last;
+    std::size_t prefixSize;
+    std::size_t elementCount;
+};
+
+/**
+ * @brief Reference to a stored config value, passed to the visitor of Config::forEach().
+ *
+ * Reading it converts the value with the same rules as Config::get(), std::string_view and std::span views of the
+ * value do not allocate. The reference must not outlive the config.
+ */
+class ConfigValueRef
+{
+public:
+    template <typename T>
+    T get() const;
+
+    bool isNull() const;
+
+    /**
+     * @brief Copy of the value, allocates for strings and arrays.
+     */
+    ConfigValue toConfigValue() const;
+
+private:
+    friend class Config;
+
+    ConfigValueRef(const Config& config, const ConfigStore& store, std::string_view keyPath, const CompactValue& value);
+
+    const Config* config;
+    const ConfigStore* store;
+    std::string_view keyPath;
+    const CompactValue* value;
+};
+
+/**
+ * @brief Range over stored key paths in key order, returned by Config::keys().
+ *
+ * The keys are views of the sorted key index of the store, iterating allocates nothing.
+ */
+class ConfigKeys
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        Iterator() = default;
+
+        std::string_view operator*() const;
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const
+        {
+            return position == other.position;
+        }
+
+    private:
+        friend class ConfigKeys;
+
+        Iterator(const ConfigKeys& keys, std::size_t position);
+
+        std::size_t skipArrayMarkers(std::size_t from) const;
+
+        const ConfigKeys* keys = nullptr;
+        std::size_t position = 0;
+    };
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    friend class Config;
+
+    ConfigKeys(const ConfigStore& store, std::size_t first, std::size_t last);
+
+    const ConfigStore* store;
+    std::size_t first;
+    std::size_t last;
+};
+
+#define CONFIG_CXX_PARENS ()
+#define CONFIG_CXX_EXPAND(...)                                                                                         \
+    CONFIG_CXX_EXPAND3(CONFIG_CXX_EXPAND3(CONFIG_CXX_EXPAND3(CONFIG_CXX_EXPAND3(__VA_ARGS__))))
+#define CONFIG_CXX_EXPAND3(...)                                                                                        \
+    CONFIG_CXX_EXPAND2(CONFIG_CXX_EXPAND2(CONFIG_CXX_EXPAND2(CONFIG_CXX_EXPAND2(__VA_ARGS__))))
+#define CONFIG_CXX_EXPAND2(...)                                                                                        \
+    CONFIG_CXX_EXPAND1(CONFIG_CXX_EXPAND1(CONFIG_CXX_EXPAND1(CONFIG_CXX_EXPAND1(__VA_ARGS__))))
+#define CONFIG_CXX_EXPAND1(...)                                                                                        \
+    CONFIG_CXX_EXPAND0(CONFIG_CXX_EXPAND0(CONFIG_CXX_EXPAND0(CONFIG_CXX_EXPAND0(__VA_ARGS__))))
+#define CONFIG_CXX_EXPAND0(...) __VA_ARGS__
+// Every rescan of CONFIG_CXX_EXPAND expands one more field, which allows up to 256 fields
+#define CONFIG_CXX_VISIT_FIELDS(...) __VA_OPT__(CONFIG_CXX_EXPAND(CONFIG_CXX_VISIT_FIELD(__VA_ARGS__)))
+#define CONFIG_CXX_VISIT_FIELD(field, ...)                                                                             \
+    visitor(#field, object.field);                                                                                     \
+    __VA_OPT__(CONFIG_CXX_VISIT_FIELD_AGAIN CONFIG_CXX_PARENS(__VA_ARGS__))
+#define CONFIG_CXX_VISIT_FIELD_AGAIN() CONFIG_CXX_VISIT_FIELD
+
+/**
+ * @brief Describe the fields of a struct, so that Config::bind() can fill it.
+ *
+ * Use it at namespace scope next to the struct, every listed field must be public and is read from the key of the same
+ * name. Fields can be any type supported by Config::get(), std::optional of such a type, a described struct, an
+ * std::optional of one, or an std::vector of described structs for arrays of objects.
+ *
+ * @code
+ * struct DbSettings
+ * {
+ *     std::string host;
+ *     int port;
+ *     std::optional<std::string> user;
+ * };
+ *
+ * CONFIG_CXX_DESCRIBE(DbSettings, host, port, user);
+ * @endcode
+ */
+#define CONFIG_CXX_DESCRIBE(Type, ...)                                                                                 \
+    template <typename Visitor>                                                                                        \
+    void configCxxDescribe([[maybe_unused]] Type& object, [[maybe_unused]] Visitor&& visitor)                          \
+    {                                                                                                                  \
+        CONFIG_CXX_VISIT_FIELDS(__VA_ARGS__)                                                                           \
+    }                                                                                                                  \
+    static_assert(std::is_class_v<Type>, "CONFIG_CXX_DESCRIBE() describes the fields of a struct")
+
+namespace detail
+{
+struct FieldVisitor
+{
+    template <typename Field>
+    void operator()(std::string_view name, Field& field) const;
+};
+
+// Found by argument dependent lookup in the namespace of the struct
+template <typename T>
+concept DescribedStruct = requires(T& object) { configCxxDescribe(object, FieldVisitor{}); };
+
+template <typename T>
+inline constexpr bool isOptional = false;
+
+template <typename T>
+inline constexpr bool isOptional<std::optional<T>> = true;
+
+template <typename T>
+inline constexpr bool isOptionalStruct = false;
+
+template <DescribedStruct T>
+inline constexpr bool isOptionalStruct<std::optional<T>> = true;
+
+template <typename T>
+inline constexpr bool isStructVector = false;
+
+template <DescribedStruct T>
+inline constexpr bool isStructVector<std::vector<T>> = true;
+
+// Types Config::get() is instantiated for in the library
+template <typename T>
+inline constexpr bool isReadable =
+    std::is_same_v<T, int> || std::is_same_v<T, bool> || std::is_same_v<T, float> || std::is_same_v<T, double> ||
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, std::vector<std::string>> || std::is_same_v<T, std::vector<int>> ||
+    std::is_same_v<T, std::vector<double>> || std::is_same_v<T, std::vector<float>> ||
+    std::is_same_v<T, std::vector<bool>> || std::is_same_v<T, std::span<const int>> ||
+    std::is_same_v<T, std::span<const double>> || std::is_same_v<T, std::span<const bool>> ||
+    std::is_same_v<T, std::span<const std::string_view>>;
+}
+
+enum class EmbeddedType : std::uint8_t
+{
+    Null,
+    Bool,
+    Int,
+    Float,
+    Double,
+    String,
+    StringArray,
+    IntArray,
+    DoubleArray,
+    BoolArray
+};
+
+/**
+ * @brief One value of a config embedded at build time.
+ *
+ * Scalars other than strings are stored in number, arrays of ints, doubles and bools in numbers.
+ */
+struct EmbeddedEntry
+{
+    std::string_view key;
+    EmbeddedType type = EmbeddedType::Null;
+    double number = 0;
+    std::string_view text;
+    std::span<const double> numbers;
+    std::span<const std::string_view> texts;
+};
+
+/**
+ * @brief Key whose value is read from an environment variable when an embedded config is loaded.
+ */
+struct EmbeddedVariable
+{
+    std::string_view key;
+    std::string_view variableName;
+};
+
+/**
+ * @brief Constant table of config values generated by the config_cxx_embed() CMake function.
+ *
+ * The generator runs the config file loaders at build time and merges the files of a config directory in the same
+ * order as Config does at runtime. Entries are sorted by key, so values can also be looked up at compile time. Keys
+ * mapped by custom environment variable files are kept as variable names and only resolved when the config is loaded.
+ *
+ * @code
+ * #include "config-cxx-embedded/sidecarConfig.h"
+ *
+ * static_assert(config::embedded::sidecarConfig.find("db.port")->number == 5432);
+ *
+ * config::Config config{config::embedded::sidecarConfig};
+ * @endcode
+ */
+class EmbeddedConfig
+{
+public:
+    constexpr EmbeddedConfig(std::span<const EmbeddedEntry> entries, std::span<const EmbeddedVariable> variables = {})
+        : entries{entries}, variables{variables}
+    {
+    }
+
+    constexpr std::span<const EmbeddedEntry> getEntries() const
+    {
+        return entries;
+    }
+
+    constexpr std::span<const EmbeddedVariable> getVariables() const
+    {
+        return variables;
+    }
+
+    /**
+     * @brief Binary search of the sorted entries, nullptr if the key is not embedded.
+     */
+    constexpr const EmbeddedEntry* find(std::string_view keyPath) const
+    {
+        std::size_t first = 0;
+        std::size_t last = entries.size();
+
+        while (first < last)
+        {
+            const auto middle = first + (last - first) / 2;
+
+            if (entries[middle].key < keyPath)
+            {
+                first = middle + 1;
+            }
+            else
+            {
+                last = middle;
+            }
+        }
+
+        return first < entries.size() && entries[first].key == keyPath ? &entries[first] : nullptr;
+    }
+
+private:
+    std::span<const EmbeddedEntry> entries;
+    std::span<const EmbeddedVariable> variables;
+};
+
+/**
+ * @brief Sources layered on top of an embedded config when it is loaded.
+ */
+enum class EmbeddedOverrides
+{
+    // Only the embedded values, loading reads no files and no environment variables
+    None,
+    // Mapped environment variables and CXX_CONFIG_ENV_PREFIX overrides
+    Environment,
+    // Config files of the config directory, then the environment as above
+    FilesAndEnvironment
+};
+
+/**
+ * @brief Handle to the configuration of the process.
+ *
+ * Constructing a config is free, the files are loaded by load(), loadAsync() or on first access. The loaded values
+ * are frozen into an immutable store that is shared by every config of the process with the same config directory,
+ * CXX_ENV and memory resource, so each configuration is parsed and kept in memory once. The store is released with the
+ * last config referring to it, configs created afterwards load the files again.
+ */
 class Config
 {
 public:
+    Config() = default;
+
+    /**
+     * @brief Create a config that allocates its frozen values from the given memory resource.
+     *
+     * Loaded keys and values are packed into a single arena requested from the resource when the config is first
+     * read. The resource must outlive the config.
+     *
+     * @param memoryResource The memory resource used for the config values.
+     *
+     * @code
+     * std::pmr::monotonic_buffer_resource resource{1 << 20};
+     * config::Config config{&resource};
+     * @endcode
+     */
+    explicit Config(std::pmr::memory_resource* memoryResource);
+
+    /**
+     * @brief Create a config reading the values embedded at build time by config_cxx_embed().
+     *
+     * With EmbeddedOverrides::None loading does no file I/O and no parsing, the embedded values are only frozen into
+     * the store. Other overrides layer config files and environment variables on top of the embedded values, with the
+     * same precedence as between the config files themselves. The embedded config must outlive the config.
+     *
+     * @param embeddedConfig The embedded config values.
+     * @param overrides The sources applied on top of the embedded values.
+     * @param memoryResource The memory resource used for the config values.
+     *
+     * @code
+     * config::Config config{config::embedded::sidecarConfig, config::EmbeddedOverrides::Environment};
+     * @endcode
+     */
+    explicit Config(const EmbeddedConfig& embeddedConfig, EmbeddedOverrides overrides = EmbeddedOverrides::None,
+                    std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource());
+
     /**
      * @brief Get a config value by path.
      *
@@ -34,13 +753,23 @@ public:
      *
      * @return The value of config key casted to provided type.
      *
+     * Array elements are addressed by index, either as "ports[2]" or "ports.2". Arrays of numbers and bools are stored
+     * contiguously in their own type, std::span<const T> views them without copying for as long as the config lives.
+     * Strings are viewed the same way with std::string_view and std::span<const std::string_view>, reading them does
+     * not allocate.
+     *
      * @code
      * Config().get<std::string>("db.host") // "localhost"
+     * Config().get<std::string_view>("db.host") // view of "localhost"
      * Config().get<int>("db.port") // 3306
+     * Config().get<int>("ports[2]") // 8082
+     * Config().get<int>("servers[1].port") // 8081
+     * Config().get<std::vector<int>>("ports") // {8080, 8081, 8082}
+     * Config().get<std::span<const int>>("ports") // view of {8080, 8081, 8082}
      * @endcode
      */
     template <typename T>
-    T get(const std::string& keyPath);
+    T get(KeyPath keyPath);
 
     /**
      * @brief Get a config value by path if it exists.
@@ -58,7 +787,7 @@ public:
      * @endcode
      */
     template <typename T>
-    std::optional<T> getOptional(const std::string& keyPath);
+    std::optional<T> getOptional(KeyPath keyPath);
 
     /**
      * @brief Get a config value by path with a default value.
@@ -76,7 +805,7 @@ public:
      * @endcode
      */
     template <typename T>
-    T getOrDefault(const std::string& keyPath, T defaultValue);
+    T getOrDefault(KeyPath keyPath, T defaultValue);
 
     /**
      * @brief Get a config value by path.
@@ -90,21 +819,201 @@ public:
      * Config().get("db.port") // 3306
      * @endcode
      */
-    ConfigValue get(const std::string& keyPath);
+    ConfigValue get(KeyPath keyPath);
+
+    /**
+     * @brief Get the number of elements of an array.
+     *
+     * @param keyPath The path to an array of values or objects.
+     *
+     * @return The number of elements, read from the store without visiting them.
+     *
+     * @code
+     * Config().size("ports") // 3
+     * Config().size("servers") // 2
+     * @endcode
+     */
+    std::size_t size(KeyPath keyPath);
+
+    /**
+     * @brief Iterate over the elements of an array of objects.
+     *
+     * Fields of an element can also be read directly by index, as "servers[1].port" or "servers.1.port".
+     *
+     * @param keyPath The path to an array of objects.
+     *
+     * @return Range of views, one per element in source order. The views must not outlive the config.
+     *
+     * @code
+     * for (const auto& server : Config().elements("servers"))
+     * {
+     *     server.get<std::string>("host") // "alpha", "beta"
+     * }
+     * @endcode
+     */
+    ConfigElements elements(KeyPath keyPath);
+
+    /**
+     * @brief Get a view of the keys nested under a path.
+     *
+     * The subtree is found once, keys read through the view are looked up relative to it without building their full
+     * key path. Views nest with ConfigView::view() and list their keys with ConfigView::children().
+     *
+     * @param keyPath The path to an object, an empty path views the whole config.
+     *
+     * @return View of the keys under the path. The view must not outlive the config.
+     *
+     * @throws std::runtime_error if no keys are nested under the path.
+     *
+     * @code
+     * const auto pool = Config().view("db.pool");
+     * pool.get<int>("max") // 10
+     * @endcode
+     */
+    ConfigView view(KeyPath keyPath);
+
+    /**
+     * @brief Visit every value stored under a path.
+     *
+     * Values are visited in key order, which is deterministic: keys are compared segment by segment, numeric segments
+     * first and as numbers, so "roles.2" comes before "roles.10" and "roles.1a". Elements of arrays of objects are
+     * visited as their own keys, "servers.0.host", arrays of values as one key. Neither keys nor values are copied.
+     *
+     * @param keyPath The path to visit the nested keys of, an empty path visits the whole config.
+     * @param visitor Called with the full key path as std::string_view and a ConfigValueRef to its value.
+     *
+     * @code
+     * Config().forEach("db", [](std::string_view key, const config::ConfigValueRef& value)
+     * {
+     *     key // "db.host", "db.port"
+     * });
+     * @endcode
+     */
+    template <typename Visitor>
+    void forEach(KeyPath keyPath, Visitor&& visitor);
+
+    /**
+     * @brief List the keys of the values stored under a path, in the same order as forEach().
+     *
+     * @param keyPath The path to list the nested keys of, an empty path lists the whole config.
+     *
+     * @return Range of key paths viewing the store, empty if nothing is stored under the path.
+     *
+     * @code
+     * for (const auto key : Config().keys("db"))
+     * {
+     *     key // "db.host", "db.port"
+     * }
+     * @endcode
+     */
+    ConfigKeys keys(KeyPath keyPath);
+
+    /**
+     * @brief Fill a struct described with CONFIG_CXX_DESCRIBE() from the keys nested under a path.
+     *
+     * The store is read once and the subtree is found with a single prefix lookup, every field is then looked up
+     * relative to it without building its full key path. Nested described structs are filled from the keys nested
+     * under their field name.
+     *
+     * @tparam T The described struct.
+     *
+     * @param keyPath The path to the keys of the struct, an empty path binds the whole config.
+     *
+     * @return The filled struct.
+     *
+     * @throws std::runtime_error listing every field that is missing or has a wrong type.
+     *
+     * @code
+     * CONFIG_CXX_DESCRIBE(DbSettings, host, port, user);
+     *
+     * const auto db = Config().bind<DbSettings>("db");
+     * db.port // 3306
+     * @endcode
+     */
+    template <typename T>
+    T bind(KeyPath keyPath);
+
+    /**
+     * @brief Get a handle to a config key, resolved and type checked once.
+     *
+     * @tparam T The target type of config value.
+     *
+     * @param keyPath The path to config key.
+     *
+     * @return Resolved handle, reading it costs a single memory load.
+     *
+     * @code
+     * const auto dbPort = Config().handle<int>("db.port");
+     * dbPort.get() // 3306
+     * @endcode
+     */
+    template <typename T>
+    ConfigKey<T> handle(KeyPath keyPath);
+
+    /**
+     * @brief Resolve every ConfigKey handle declared in the program against this config.
+     *
+     * Handles returned by handle() are not resolved again, they keep the value of the config that returned them.
+     *
+     * All keys are resolved in one pass, a single exception lists every key that is missing or has a wrong type.
+     *
+     * @code
+     * const config::ConfigKey<int> dbPort{"db.port"};
+     * const config::ConfigKey<std::string> dbHost{"db.host"};
+     *
+     * Config().resolveKeys();
+     * @endcode
+     */
+    void resolveKeys();
 
     /**
      * @brief Check if a config key exists.
      *
      * @param keyPath The path to config key.
      *
-     * @return True if config key is defined, false otherwise.
+     * @return True if config key or any key nested under it is defined, false otherwise.
      *
      * @code
      * Config().has("db.host") // true
+     * Config().has("db") // true
      * Config().has("db.user") // false
      * @endcode
      */
-    bool has(const std::string& keyPath);
+    bool has(KeyPath keyPath);
+
+    /**
+     * @brief Load the configuration now instead of on first access.
+     *
+     * Reads the config files, or adopts the values already loaded by another config of the process. Does nothing if
+     * the config is loaded already. Errors in the config files are thrown from here instead of from the first read.
+     *
+     * @code
+     * config::Config config;
+     * config.load();
+     * @endcode
+     */
+    void load();
+
+    /**
+     * @brief Load the configuration on a background thread.
+     *
+     * Reads started while loading is in progress wait for it to finish. The config must outlive the returned future,
+     * destroying the future waits for loading to finish.
+     *
+     * @return Future that is ready once the config is loaded and rethrows loading errors from get().
+     *
+     * @code
+     * auto loaded = config.loadAsync();
+     * warmUpConnectionPool();
+     * loaded.get();
+     * @endcode
+     */
+    std::future<void> loadAsync();
+
+    /**
+     * @brief Check if the configuration is loaded, without loading it.
+     */
+    bool isLoaded() const;
 
     /**
      * @brief Set a logging callback for config operations.
@@ -122,16 +1031,176 @@ public:
     void setLogCallback(LogCallback callback);
 
 private:
-    std::vector<std::string> getArray(const std::string& keyPath);
-    void initialize();
+    friend class ConfigValueRef;
+    friend class ConfigView;
+
+    using EntryVisitor = void (*)(void* visitor, std::string_view keyPath, const ConfigValueRef& value);
+
+    void visitEntries(KeyPath keyPath, void* visitor, EntryVisitor visit);
+
+    template <typename T>
+    T getValue(const ConfigStore& snapshot, const std::optional<CompactValue>& value, std::string_view prefix,
+               std::string_view keyPath) const;
+    template <typename T>
+    std::optional<T> getOptionalValue(const ConfigStore& snapshot, const std::optional<CompactValue>& value,
+                                      std::string_view prefix, std::string_view keyPath) const;
+    static std::string joinKeyPath(std::string_view prefix, std::string_view keyPath);
+
+    std::optional<ConfigView> findView(KeyPath keyPath);
+    [[noreturn]] void throwNoNestedKeys(const ConfigStore& snapshot, const std::string& keyPath) const;
+    template <typename T>
+    void bindFields(const ConfigView& view, T& object, std::vector<std::string>& errors) const;
+    template <typename Field>
+    void bindField(const ConfigView& view, std::string_view name, Field& field, std::vector<std::string>& errors) const;
+    void addBindError(std::vector<std::string>& errors, std::string_view prefix, std::string_view keyPath,
+                      std::string_view problem) const;
+    [[noreturn]] static void throwBindErrors(std::string_view keyPath, const std::vector<std::string>& errors);
+
+    const ConfigStore& getStore();
+    const ConfigStore& loadStore();
+    std::vector<std::string> getArray(const ConfigStore& snapshot, std::string_view keyPath) const;
+    std::shared_ptr<const ConfigStore> getSharedStore() const;
+    std::shared_ptr<const ConfigStore> initialize(const std::filesystem::path& configDirectory,
+                                                  const std::string& cxxEnv) const;
+    std::shared_ptr<const ConfigStore> initializeEmbedded(const std::filesystem::path& configDirectory,
+                                                          const std::string& cxxEnv) const;
     void log(LogLevel level, const std::string& message) const;
-    std::string getSimilarKeys(const std::string& keyPath) const;
-    std::string getTypeString(const ConfigValue& value) const;
+    std::string getSimilarKeys(const ConfigStore& snapshot, std::string_view keyPath) const;
+    std::string getTypeString(const CompactValue& value) const;
 
-    bool initialized = false;
     LogCallback logCallback;
+    mutable std::mutex logLock;
 
-    std::unordered_map<std::string, ConfigValue> values;
-    mutable std::mutex lock;
+    // Published once after initialization; readers only perform an acquire load of this pointer.
+    std::atomic<const ConfigStore*> store{nullptr};
+    std::shared_ptr<const ConfigStore> storeOwner;
+    std::mutex lock;
+    std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource();
+    std::optional<EmbeddedConfig> embeddedConfig;
+    EmbeddedOverrides embeddedOverrides = EmbeddedOverrides::None;
 };
+
+template <typename T>
+ConfigKey<T> Config::handle(KeyPath keyPath)
+{
+    // Not registered, resolveKeys() must not resolve it again against another config
+    ConfigKey<T> key{std::string{keyPath.getPath()}, false};
+
+    static_cast<const ConfigKeyBase&>(key).resolve(*this);
+
+    return key;
+}
+
+template <typename Visitor>
+void Config::forEach(KeyPath keyPath, Visitor&& visitor)
+{
+    // Type erased through a function pointer, so visiting neither allocates nor copies the visitor
+    visitEntries(keyPath, const_cast<void*>(static_cast<const void*>(std::addressof(visitor))),
+                 [](void* erasedVisitor, std::string_view entryKeyPath, const ConfigValueRef& value)
+                 { (*static_cast<std::remove_reference_t<Visitor>*>(erasedVisitor))(entryKeyPath, value); });
+}
+
+template <typename T>
+T Config::bind(KeyPath keyPath)
+{
+    static_assert(detail::DescribedStruct<T>, "Describe the fields of the struct with CONFIG_CXX_DESCRIBE()");
+
+    T result{};
+    std::vector<std::string> errors;
+
+    if (const auto view = findView(keyPath))
+    {
+        bindFields(*view, result, errors);
+    }
+    else
+    {
+        addBindError(errors, {}, keyPath.getPath(), "not found");
+    }
+
+    if (!errors.empty())
+    {
+        throwBindErrors(keyPath.getPath(), errors);
+    }
+
+    return result;
+}
+
+template <typename T>
+void Config::bindFields(const ConfigView& view, T& object, std::vector<std::string>& errors) const
+{
+    configCxxDescribe(object, [&](std::string_view name, auto& field) { bindField(view, name, field, errors); });
+}
+
+template <typename Field>
+void Config::bindField(const ConfigView& view, std::string_view name, Field& field,
+                       std::vector<std::string>& errors) const
+{
+    if constexpr (detail::DescribedStruct<Field>)
+    {
+        if (const auto nested = view.findView(name))
+        {
+            bindFields(*nested, field, errors);
+        }
+        else
+        {
+            addBindError(errors, view.getKeyPath(), name, "not found");
+        }
+    }
+    else if constexpr (detail::isOptionalStruct<Field>)
+    {
+        if (const auto nested = view.findView(name))
+        {
+            bindFields(*nested, field.emplace(), errors);
+        }
+    }
+    else if constexpr (detail::isStructVector<Field>)
+    {
+        if (const auto elements = view.findElements(name))
+        {
+            field.reserve(elements->size());
+
+            for (const auto& element : *elements)
+            {
+                bindFields(element, field.emplace_back(), errors);
+            }
+        }
+        else
+        {
+            addBindError(errors, view.getKeyPath(), name, "is not an array of objects");
+        }
+    }
+    else if constexpr (detail::isOptional<Field>)
+    {
+        static_assert(detail::isReadable<typename Field::value_type>, "Field type is not supported by Config::get()");
+
+        try
+        {
+            field = view.getOptional<typename Field::value_type>(name);
+        }
+        catch (const std::runtime_error& error)
+        {
+            errors.push_back(error.what());
+        }
+    }
+    else
+    {
+        static_assert(detail::isReadable<Field>, "Field type is not supported by Config::get()");
+
+        try
+        {
+            field = view.get<Field>(name);
+        }
+        catch (const std::runtime_error& error)
+        {
+            errors.push_back(error.what());
+        }
+    }
+}
+
+template <typename T>
+void ConfigKey<T>::resolve(Config& config) const
+{
+    value = config.get<T>(keyPath);
+    resolved = true;
+}
 }
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace config
+{
+/**
+ * Appends trivially copyable values and length prefixed strings to a buffer, in native byte order.
+ */
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(std::string& buffer) : buffer{buffer} {}
+
+    template <typename T>
+    void write(T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeBytes(std::string_view bytes)
+    {
+        buffer.append(bytes);
+    }
+
+    void writeString(std::string_view text)
+    {
+        write(static_cast<std::uint32_t>(text.size()));
+        writeBytes(text);
+    }
+
+private:
+    std::string& buffer;
+};
+
+/**
+ * Reads values written by BinaryWriter. Reading past the end of the buffer throws std::runtime_error, values are
+ * copied out, so the buffer needs no alignment.
+ */
+class BinaryReader
+{
+public:
+    explicit BinaryReader(std::string_view buffer) : buffer{buffer} {}
+
+    template <typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        T value;
+        std::memcpy(&value, readBytes(sizeof(value)).data(), sizeof(value));
+
+        return value;
+    }
+
+    std::string_view readBytes(std::size_t size)
+    {
+        if (size > buffer.size())
+        {
+            throw std::runtime_error("Unexpected end of binary data");
+        }
+
+        const auto bytes = buffer.substr(0, size);
+        buffer.remove_prefix(size);
+
+        return bytes;
+    }
+
+    std::string_view readString()
+    {
+        return readBytes(read<std::uint32_t>());
+    }
+
+    // Element counts are checked against the remaining bytes before anything is allocated for them
+    std::uint32_t readCount(std::size_t minElementSize)
+    {
+        const auto count = read<std::uint32_t>();
+
+        if (count * minElementSize > buffer.size())
+        {
+            throw std::runtime_error("Unexpected end of binary data");
+        }
+
+        return count;
+    }
+
+    bool atEnd() const
+    {
+        return buffer.empty();
+    }
+
+private:
+    std::string_view buffer;
+};
+}
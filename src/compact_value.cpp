@@ -0,0 +1,210 @@
+#include "compact_value.h"
+
+#include <vector>
+
+namespace config
+{
+CompactValue CompactValue::fromBool(bool value)
+{
+    CompactValue result;
+    result.type = Type::Bool;
+    result.boolValue = value;
+    return result;
+}
+
+CompactValue CompactValue::fromInt(int value)
+{
+    CompactValue result;
+    result.type = Type::Int;
+    result.intValue = value;
+    return result;
+}
+
+CompactValue CompactValue::fromDouble(double value)
+{
+    CompactValue result;
+    result.type = Type::Double;
+    result.doubleValue = value;
+    return result;
+}
+
+CompactValue CompactValue::fromFloat(float value)
+{
+    CompactValue result;
+    result.type = Type::Float;
+    result.floatValue = value;
+    return result;
+}
+
+CompactValue CompactValue::fromString(std::string_view value)
+{
+    CompactValue result;
+    result.type = Type::String;
+    result.size = static_cast<std::uint32_t>(value.size());
+    result.chars = value.data();
+    return result;
+}
+
+CompactValue CompactValue::fromStringArray(std::span<const std::string_view> value)
+{
+    CompactValue result;
+    result.type = Type::StringArray;
+    result.size = static_cast<std::uint32_t>(value.size());
+    result.elements = value.data();
+    return result;
+}
+
+CompactValue CompactValue::fromIntArray(std::span<const int> value)
+{
+    CompactValue result;
+    result.type = Type::IntArray;
+    result.size = static_cast<std::uint32_t>(value.size());
+    result.ints = value.data();
+    return result;
+}
+
+CompactValue CompactValue::fromDoubleArray(std::span<const double> value)
+{
+    CompactValue result;
+    result.type = Type::DoubleArray;
+    result.size = static_cast<std::uint32_t>(value.size());
+    result.doubles = value.data();
+    return result;
+}
+
+CompactValue CompactValue::fromBoolArray(std::span<const bool> value)
+{
+    CompactValue result;
+    result.type = Type::BoolArray;
+    result.size = static_cast<std::uint32_t>(value.size());
+    result.bools = value.data();
+    return result;
+}
+
+CompactValue CompactValue::fromObjectArray(std::size_t elementCount)
+{
+    CompactValue result;
+    result.type = Type::ObjectArray;
+    result.size = static_cast<std::uint32_t>(elementCount);
+    return result;
+}
+
+CompactValue::Type CompactValue::getType() const
+{
+    return type;
+}
+
+bool CompactValue::isNull() const
+{
+    return type == Type::Null;
+}
+
+bool CompactValue::asBool() const
+{
+    return boolValue;
+}
+
+int CompactValue::asInt() const
+{
+    return intValue;
+}
+
+double CompactValue::asDouble() const
+{
+    return doubleValue;
+}
+
+float CompactValue::asFloat() const
+{
+    return floatValue;
+}
+
+std::string_view CompactValue::asString() const
+{
+    return {chars, size};
+}
+
+std::span<const std::string_view> CompactValue::asStringArray() const
+{
+    return {elements, size};
+}
+
+std::span<const int> CompactValue::asIntArray() const
+{
+    return {ints, size};
+}
+
+std::span<const double> CompactValue::asDoubleArray() const
+{
+    return {doubles, size};
+}
+
+std::span<const bool> CompactValue::asBoolArray() const
+{
+    return {bools, size};
+}
+
+bool CompactValue::isArray() const
+{
+    return type >= Type::StringArray;
+}
+
+std::size_t CompactValue::getArraySize() const
+{
+    return isArray() ? size : 0;
+}
+
+std::optional<CompactValue> CompactValue::getElement(std::size_t index) const
+{
+    if (!isArray() || index >= size)
+    {
+        return std::nullopt;
+    }
+
+    switch (type)
+    {
+    case Type::StringArray:
+        return fromString(elements[index]);
+    case Type::IntArray:
+        return fromInt(ints[index]);
+    case Type::DoubleArray:
+        return fromDouble(doubles[index]);
+    case Type::BoolArray:
+        return fromBool(bools[index]);
+    default:
+        return std::nullopt;
+    }
+}
+
+ConfigValue CompactValue::toConfigValue() const
+{
+    switch (type)
+    {
+    case Type::Bool:
+        return boolValue;
+    case Type::Int:
+        return intValue;
+    case Type::Double:
+        return doubleValue;
+    case Type::String:
+        return std::string{asString()};
+    case Type::Float:
+        return floatValue;
+    case Type::StringArray:
+    {
+        const auto stringArray = asStringArray();
+        return std::vector<std::string>(stringArray.begin(), stringArray.end());
+    }
+    case Type::IntArray:
+        return std::vector<int>(ints, ints + size);
+    case Type::DoubleArray:
+        return std::vector<double>(doubles, doubles + size);
+    case Type::BoolArray:
+        return std::vector<bool>(bools, bools + size);
+    case Type::ObjectArray:
+    case Type::Null:
+    default:
+        return nullptr;
+    }
+}
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "config-cxx/config.h"
+#include "config_value.h"
+
+namespace config
+{
+/**
+ * 16 byte tagged representation of a config value used for storage inside ConfigStore.
+ *
+ * Scalars are stored inline. Strings and arrays point into buffers owned by the store, so a value must not outlive
+ * the store that created it. Arrays keep their elements contiguous in the element type. ConfigValue is only built on demand, when the public API returns one.
+ */
+class CompactValue
+{
+public:
+    // Same order as the alternatives of ConfigValue
+    enum class Type : std::uint8_t
+    {
+        Null,
+        Bool,
+        Int,
+        Double,
+        String,
+        Float,
+        StringArray,
+        IntArray,
+        DoubleArray,
+        BoolArray,
+        // Array of objects or arrays, the elements are stored as separate keys below "key.0", "key.1", ...
+        ObjectArray
+    };
+
+    CompactValue() = default;
+
+    static CompactValue fromBool(bool value);
+    static CompactValue fromInt(int value);
+    static CompactValue fromDouble(double value);
+    static CompactValue fromFloat(float value);
+    static CompactValue fromString(std::string_view value);
+    static CompactValue fromStringArray(std::span<const std::string_view> value);
+    static CompactValue fromIntArray(std::span<const int> value);
+    static CompactValue fromDoubleArray(std::span<const double> value);
+    static CompactValue fromBoolArray(std::span<const bool> value);
+    static CompactValue fromObjectArray(std::size_t elementCount);
+
+    Type getType() const;
+    bool isNull() const;
+    bool asBool() const;
+    int asInt() const;
+    double asDouble() const;
+    float asFloat() const;
+    std::string_view asString() const;
+    std::span<const std::string_view> asStringArray() const;
+    std::span<const int> asIntArray() const;
+    std::span<const double> asDoubleArray() const;
+    std::span<const bool> asBoolArray() const;
+
+    bool isArray() const;
+    std::size_t getArraySize() const;
+    std::optional<CompactValue> getElement(std::size_t index) const;
+
+    ConfigValue toConfigValue() const;
+
+private:
+    Type type = Type::Null;
+    std::uint32_t size = 0;
+
+    union
+    {
+        std::uint64_t bits = 0;
+        bool boolValue;
+        int intValue;
+        double doubleValue;
+        float floatValue;
+        const char* chars;
+        const std::string_view* elements;
+        const int* ints;
+        const double* doubles;
+        const bool* bools;
+    };
+};
+
+static_assert(sizeof(CompactValue) == 16, "CompactValue must stay 16 bytes");
+
+template <typename T>
+struct IsSpan : std::false_type
+{
+};
+
+template <typename T>
+struct IsSpan<std::span<T>> : std::true_type
+{
+};
+
+template <typename T>
+struct IsArithmeticVector : std::false_type
+{
+};
+
+template <typename T>
+struct IsArithmeticVector<std::vector<T>> : std::is_arithmetic<T>
+{
+};
+
+template <typename Element, typename Source>
+std::vector<Element> convertElements(std::span<const Source> elements)
+{
+    std::vector<Element> result;
+    result.reserve(elements.size());
+
+    for (const auto element : elements)
+    {
+        result.push_back(static_cast<Element>(element));
+    }
+
+    return result;
+}
+
+/**
+ * Converts a stored value to the requested type with the same rules as config::cast() on ConfigValue.
+ * Numbers, matching strings and arrays are converted directly, other conversions go through ConfigValue.
+ * A std::span<const T> is only returned for an array stored with element type T and views the store, likewise a
+ * std::string_view is only returned for a string value. An empty array has no element type and converts to any array.
+ */
+template <typename T>
+std::optional<T> cast(const CompactValue& value)
+{
+    if constexpr (IsSpan<T>::value || IsArithmeticVector<T>::value || std::is_same_v<T, std::vector<std::string>>)
+    {
+        if (value.isArray() && value.getArraySize() == 0)
+        {
+            return T{};
+        }
+    }
+
+    if constexpr (IsSpan<T>::value)
+    {
+        using Element = std::remove_const_t<typename T::element_type>;
+
+        if constexpr (std::is_same_v<Element, int>)
+        {
+            if (value.getType() == CompactValue::Type::IntArray)
+            {
+                return value.asIntArray();
+            }
+        }
+        else if constexpr (std::is_same_v<Element, double>)
+        {
+            if (value.getType() == CompactValue::Type::DoubleArray)
+            {
+                return value.asDoubleArray();
+            }
+        }
+        else if constexpr (std::is_same_v<Element, bool>)
+        {
+            if (value.getType() == CompactValue::Type::BoolArray)
+            {
+                return value.asBoolArray();
+            }
+        }
+        else if constexpr (std::is_same_v<Element, std::string_view>)
+        {
+            if (value.getType() == CompactValue::Type::StringArray)
+            {
+                return value.asStringArray();
+            }
+        }
+
+        return std::nullopt;
+    }
+    else if constexpr (IsArithmeticVector<T>::value)
+    {
+        using Element = typename T::value_type;
+
+        switch (value.getType())
+        {
+        case CompactValue::Type::IntArray:
+            return convertElements<Element>(value.asIntArray());
+        case CompactValue::Type::DoubleArray:
+            return convertElements<Element>(value.asDoubleArray());
+        case CompactValue::Type::BoolArray:
+            return convertElements<Element>(value.asBoolArray());
+        default:
+            return std::nullopt;
+        }
+    }
+    else if constexpr (std::is_same_v<T, std::vector<std::string>>)
+    {
+        if (value.getType() == CompactValue::Type::StringArray)
+        {
+            const auto stringArray = value.asStringArray();
+            return std::vector<std::string>(stringArray.begin(), stringArray.end());
+        }
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        switch (value.getType())
+        {
+        case CompactValue::Type::Bool:
+            return static_cast<T>(value.asBool());
+        case CompactValue::Type::Int:
+            return static_cast<T>(value.asInt());
+        case CompactValue::Type::Double:
+            return static_cast<T>(value.asDouble());
+        case CompactValue::Type::Float:
+            return static_cast<T>(value.asFloat());
+        default:
+            return std::nullopt;
+        }
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        if (value.getType() == CompactValue::Type::String)
+        {
+            return std::string{value.asString()};
+        }
+    }
+    else if constexpr (std::is_same_v<T, std::string_view>)
+    {
+        // Only strings are stored as text, other values would need a temporary to view
+        if (value.getType() == CompactValue::Type::String)
+        {
+            return value.asString();
+        }
+
+        return std::nullopt;
+    }
+
+    if constexpr (!std::is_same_v<T, std::string_view>)
+    {
+        return config::cast<T>(value.toConfigValue());
+    }
+}
+}
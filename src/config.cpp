@@ -1,228 +1,1339 @@
 #include "config-cxx/config.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <map>
 #include <optional>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <variant>
 
 #include "config_directory_path_resolver.h"
+#include "config_file_loader.h"
 #include "config_provider.h"
+#include "config_store.h"
 #include "config_value.h"
-#include "json_config_loader.h"
-#include "xml_config_loader.h"
-#include "yaml_config_loader.h"
+#include "snapshot_cache.h"
 
 namespace config
 {
+namespace
+{
+// Stores are shared by all configs loading the same directory for the same environment into the same memory resource,
+// configs of an embedded table additionally by the table and the overrides applied to it
+using SharedStoreKey = std::tuple<std::string, std::string, std::pmr::memory_resource*, const EmbeddedEntry*,
+                                  const EmbeddedVariable*, std::optional<EmbeddedOverrides>>;
+
+struct SharedStore
+{
+    // Held while the store is loaded, so a key is loaded once without blocking loads of other keys
+    std::mutex lock;
+    // Expires with the last config referring to the store, the next config loads the files again
+    std::weak_ptr<const ConfigStore> store;
+};
+
+struct SharedStores
+{
+    std::mutex lock;
+    std::map<SharedStoreKey, std::shared_ptr<SharedStore>> stores;
+};
+
+SharedStores& getSharedStores()
+{
+    static SharedStores sharedStores;
+
+    return sharedStores;
+}
+
+// Values parsed from one config file, merged into the config in file order
+struct ConfigLayer
+{
+    std::unordered_map<std::string, ConfigValue> values;
+    BorrowedStrings borrowedStrings;
+    std::exception_ptr error;
+    bool isEnvironmentFile = false;
+};
+
+// Strings of at least CXX_CONFIG_MAPPED_STRING_SIZE bytes are borrowed from mapped files, by default none are
+std::size_t getMappedStringMinSize(const environment::EnvironmentSnapshot& environment)
+{
+    const auto minSizeText = environment.getVariable("CXX_CONFIG_MAPPED_STRING_SIZE");
+    std::size_t minSize = 0;
+
+    if (!minSizeText || minSizeText->empty())
+    {
+        return BorrowedStrings{}.minSize;
+    }
+
+    const auto [end, error] = std::from_chars(minSizeText->data(), minSizeText->data() + minSizeText->size(), minSize);
+
+    if (error != std::errc{} || end != minSizeText->data() + minSizeText->size() || minSize == 0)
+    {
+        throw std::runtime_error("CXX_CONFIG_MAPPED_STRING_SIZE must be a positive number of bytes: " + *minSizeText);
+    }
+
+    return minSize;
+}
+
+// Text of an override converted to the element type of the array it is written into
+template <typename Element>
+Element parseArrayElement(const std::string& keyPath, const std::string& text)
+{
+    if constexpr (std::is_same_v<Element, std::string>)
+    {
+        return text;
+    }
+    else if constexpr (std::is_same_v<Element, bool>)
+    {
+        if (text == "true" || text == "false")
+        {
+            return text == "true";
+        }
+    }
+    else
+    {
+        Element element{};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), element);
+
+        if (error == std::errc{} && end == text.data() + text.size())
+        {
+            return element;
+        }
+    }
+
+    throw std::runtime_error("Configuration key '" + keyPath + "' override element '" + text +
+                             "' does not match the element type of the array.");
+}
+
+// Types an override like the scalar value it replaces when its text parses as that type, otherwise keeps the text.
+// An override of an array of values is a comma separated list whose elements must parse into the element type.
+ConfigValue parseOverride(const std::string& keyPath, const ConfigValue* replacedValue, const std::string& text)
+{
+    const auto parseNumber = [&](auto number) -> ConfigValue
+    {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), number);
+
+        if (error != std::errc{} || end != text.data() + text.size())
+        {
+            return text;
+        }
+
+        return number;
+    };
+
+    if (replacedValue == nullptr)
+    {
+        return text;
+    }
+
+    if (std::holds_alternative<int>(*replacedValue))
+    {
+        return parseNumber(0);
+    }
+
+    if (std::holds_alternative<double>(*replacedValue))
+    {
+        return parseNumber(0.0);
+    }
+
+    if (std::holds_alternative<float>(*replacedValue))
+    {
+        return parseNumber(0.0f);
+    }
+
+    if (std::holds_alternative<bool>(*replacedValue) && (text == "true" || text == "false"))
+    {
+        return text == "true";
+    }
+
+    return std::visit(
+        [&](const auto& replaced) -> ConfigValue
+        {
+            using Value = std::decay_t<decltype(replaced)>;
+
+            if constexpr (std::is_same_v<Value, std::vector<std::string>> || std::is_same_v<Value, std::vector<int>> ||
+                          std::is_same_v<Value, std::vector<double>> || std::is_same_v<Value, std::vector<bool>>)
+            {
+                Value elements;
+                std::size_t elementStart = 0;
+
+                while (true)
+                {
+                    const auto elementEnd = std::min(text.find(',', elementStart), text.size());
+                    elements.push_back(parseArrayElement<typename Value::value_type>(
+                        keyPath, text.substr(elementStart, elementEnd - elementStart)));
+
+                    if (elementEnd == text.size())
+                    {
+                        return elements;
+                    }
+
+                    elementStart = elementEnd + 1;
+                }
+            }
+            else
+            {
+                return text;
+            }
+        },
+        *replacedValue);
+}
+
+// Environment variable files and prefixed overrides address array elements by index ("auth.roles.0"), while config
+// files store arrays of values as one native array. Writes such an override into the element of the array, an index
+// one past the end appends an element. False when no array of values is stored under the parent key.
+bool setArrayElement(std::unordered_map<std::string, ConfigValue>& values, const std::string& arrayKeyPath,
+                     std::string_view indexText, const std::string& text)
+{
+    std::size_t index = 0;
+    const auto [end, error] = std::from_chars(indexText.data(), indexText.data() + indexText.size(), index);
+
+    if (indexText.empty() || error != std::errc{} || end != indexText.data() + indexText.size())
+    {
+        return false;
+    }
+
+    const auto array = values.find(arrayKeyPath);
+
+    if (array == values.end())
+    {
+        return false;
+    }
+
+    const auto keyPath = arrayKeyPath + "." + std::string{indexText};
+
+    return std::visit(
+        [&](auto& elements)
+        {
+            using Value = std::decay_t<decltype(elements)>;
+
+            if constexpr (std::is_same_v<Value, std::vector<std::string>> || std::is_same_v<Value, std::vector<int>> ||
+                          std::is_same_v<Value, std::vector<double>> || std::is_same_v<Value, std::vector<bool>>)
+            {
+                if (index > elements.size())
+                {
+                    throw std::runtime_error("Configuration key '" + keyPath + "' is past the end of the array of " +
+                                             std::to_string(elements.size()) + " elements it overrides.");
+                }
+
+                auto element = parseArrayElement<typename Value::value_type>(keyPath, text);
+
+                if (index == elements.size())
+                {
+                    elements.push_back(std::move(element));
+                }
+                else
+                {
+                    elements[index] = std::move(element);
+                }
+
+                return true;
+            }
+            else
+            {
+                return false;
+            }
+        },
+        array->second);
+}
+
+// Sets a value of an environment variable file or override, writing indexed keys into the array they address
+void setOverride(std::unordered_map<std::string, ConfigValue>& values, const std::string& keyPath, ConfigValue value)
+{
+    const auto* text = std::get_if<std::string>(&value);
+    const auto lastDot = keyPath.rfind('.');
+
+    if (text != nullptr && lastDot != std::string::npos && !values.contains(keyPath) &&
+        setArrayElement(values, keyPath.substr(0, lastDot), std::string_view{keyPath}.substr(lastDot + 1), *text))
+    {
+        return;
+    }
+
+    values.insert_or_assign(keyPath, std::move(value));
+}
+
+// With CXX_CONFIG_ENV_PREFIX=APP a variable APP__DB__PORT overrides db.port. Segments are matched with the loaded keys
+// ignoring case, so APP__AUTH__EXPIRESIN overrides auth.expiresIn, keys not found are added in lower case as strings.
+// Loaded keys differing only by case cannot be told apart by a variable name, overriding one of them is an error.
+void applyPrefixedEnvironmentOverrides(std::unordered_map<std::string, ConfigValue>& values,
+                                       const environment::EnvironmentSnapshot& environment)
+{
+    const auto prefix = environment.getVariable("CXX_CONFIG_ENV_PREFIX");
+
+    if (!prefix || prefix->empty())
+    {
+        return;
+    }
+
+    const auto variablePrefix = *prefix + "__";
+    const auto toLower = [](std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char character) { return static_cast<char>(std::tolower(character)); });
+        return text;
+    };
+
+    std::unordered_map<std::string, std::string> keysByLowerCase;
+    std::unordered_map<std::string, std::string> ambiguousKeysByLowerCase;
+    bool keysIndexed = false;
+
+    const auto findLoadedKey = [&](const std::string& envName, const std::string& lowerCaseKey)
+    {
+        if (const auto ambiguousKey = ambiguousKeysByLowerCase.find(lowerCaseKey);
+            ambiguousKey != ambiguousKeysByLowerCase.end())
+        {
+            throw std::runtime_error("Environment variable '" + envName + "' matches configuration keys '" +
+                                     keysByLowerCase.at(lowerCaseKey) + "' and '" + ambiguousKey->second +
+                                     "' that differ only by case.");
+        }
+
+        return keysByLowerCase.find(lowerCaseKey);
+    };
+
+    // Overrides are applied in key index order, so indexed overrides append elements past the end of an array one by
+    // one in index order instead of in the arbitrary order of the environment
+    std::vector<std::tuple<std::string, const std::string*, const std::string*>> overrides;
+
+    for (const auto& [envName, envValue] : environment.getVariables())
+    {
+        if (envValue.empty() || envName.size() <= variablePrefix.size() ||
+            envName.compare(0, variablePrefix.size(), variablePrefix) != 0)
+        {
+            continue;
+        }
+
+        std::string key;
+        key.reserve(envName.size() - variablePrefix.size());
+
+        for (auto index = variablePrefix.size(); index < envName.size(); ++index)
+        {
+            if (envName[index] == '_' && index + 1 < envName.size() && envName[index + 1] == '_')
+            {
+                key += '.';
+                ++index;
+            }
+            else
+            {
+                key += static_cast<char>(std::tolower(static_cast<unsigned char>(envName[index])));
+            }
+        }
+
+        overrides.emplace_back(std::move(key), &envName, &envValue);
+    }
+
+    std::sort(overrides.begin(), overrides.end(),
+              [](const auto& lhs, const auto& rhs)
+              { return ConfigStore::compareKeys(std::get<0>(lhs), std::get<0>(rhs)) < 0; });
+
+    for (const auto& [key, envNamePointer, envValuePointer] : overrides)
+    {
+        const auto& envName = *envNamePointer;
+        const auto& envValue = *envValuePointer;
+
+        // The index of loaded keys is only built once an override is found
+        if (!keysIndexed)
+        {
+            for (const auto& [loadedKey, value] : values)
+            {
+                if (auto [indexedKey, inserted] = keysByLowerCase.emplace(toLower(loadedKey), loadedKey); !inserted)
+                {
+                    // Keep the lesser key first so the error names both keys in the same order on every load
+                    auto otherKey = loadedKey;
+
+                    if (otherKey < indexedKey->second)
+                    {
+                        std::swap(otherKey, indexedKey->second);
+                    }
+
+                    ambiguousKeysByLowerCase.insert_or_assign(indexedKey->first, std::move(otherKey));
+                }
+            }
+
+            keysIndexed = true;
+        }
+
+        const auto lastDot = key.rfind('.');
+        const auto arrayKey = lastDot != std::string::npos ? key.substr(0, lastDot) : std::string{};
+
+        if (const auto loadedKey = findLoadedKey(envName, key); loadedKey != keysByLowerCase.end())
+        {
+            auto& value = values[loadedKey->second];
+            value = parseOverride(loadedKey->second, &value, envValue);
+        }
+        else if (const auto loadedArray = arrayKey.empty() ? keysByLowerCase.end() : findLoadedKey(envName, arrayKey);
+                 loadedArray == keysByLowerCase.end() ||
+                 !setArrayElement(values, loadedArray->second, std::string_view{key}.substr(lastDot + 1), envValue))
+        {
+            values.insert_or_assign(key, parseOverride(key, nullptr, envValue));
+        }
+    }
+}
+
+// Number of threads parsing config files, CXX_CONFIG_LOAD_THREADS overrides the number of hardware threads
+std::size_t getLoadThreadCount()
+{
+    if (const auto* loadThreads = std::getenv("CXX_CONFIG_LOAD_THREADS"))
+    {
+        std::size_t threadCount = 0;
+        const auto end = loadThreads + std::strlen(loadThreads);
+
+        if (std::from_chars(loadThreads, end, threadCount).ec == std::errc{} && threadCount > 0)
+        {
+            return threadCount;
+        }
+    }
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs task(0) to task(taskCount - 1) on up to threadCount threads including the calling one, tasks must not throw
+template <typename Task>
+void runInParallel(std::size_t taskCount, std::size_t threadCount, const Task& task)
+{
+    std::atomic<std::size_t> nextTask{0};
+
+    const auto runTasks = [&]
+    {
+        for (auto taskIndex = nextTask++; taskIndex < taskCount; taskIndex = nextTask++)
+        {
+            task(taskIndex);
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t threadIndex = 1; threadIndex < std::min(threadCount, taskCount); ++threadIndex)
+    {
+        try
+        {
+            threads.emplace_back(runTasks);
+        }
+        catch (const std::system_error&)
+        {
+            // Fewer threads only make loading slower, the remaining tasks are picked up by the running ones
+            break;
+        }
+    }
+
+    runTasks();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// Parses every file into its own layer, concurrently, and merges the layers in file order on top of the given values
+void loadConfigFiles(const std::vector<std::filesystem::path>& filePaths,
+                     const environment::EnvironmentSnapshot& environment,
+                     std::unordered_map<std::string, ConfigValue>& values, BorrowedStrings& borrowedStrings)
+{
+    std::vector<ConfigLayer> layers(filePaths.size());
+    const auto mappedStringMinSize = getMappedStringMinSize(environment);
+
+    runInParallel(filePaths.size(), getLoadThreadCount(),
+                  [&](std::size_t fileIndex)
+                  {
+                      const auto& filePath = filePaths[fileIndex];
+                      auto& layer = layers[fileIndex];
+
+                      try
+                      {
+                          // Environment variable files only hold the values of the variables they map
+                          if (ConfigFileLoader::isEnvironmentFile(filePath))
+                          {
+                              layer.isEnvironmentFile = true;
+                              ConfigFileLoader::loadConfigEnvFile(filePath, layer.values, environment);
+                          }
+                          else
+                          {
+                              layer.borrowedStrings.minSize = mappedStringMinSize;
+                              ConfigFileLoader::loadConfigFile(filePath, layer.values, layer.borrowedStrings);
+                          }
+                      }
+                      catch (...)
+                      {
+                          layer.error = std::current_exception();
+                      }
+                  });
+
+    // Layers are merged in file order, so later files override earlier ones exactly as if loaded one after another
+    for (auto& layer : layers)
+    {
+        if (layer.error)
+        {
+            std::rethrow_exception(layer.error);
+        }
+
+        // A value overriding a borrowed string would otherwise be read from the earlier file
+        if (!borrowedStrings.values.empty())
+        {
+            for (const auto& [key, value] : layer.values)
+            {
+                borrowedStrings.values.erase(key);
+            }
+        }
+
+        borrowedStrings.values.merge(layer.borrowedStrings.values);
+        std::move(layer.borrowedStrings.owners.begin(), layer.borrowedStrings.owners.end(),
+                  std::back_inserter(borrowedStrings.owners));
+
+        if (values.empty())
+        {
+            values = std::move(layer.values);
+            continue;
+        }
+
+        if (!layer.isEnvironmentFile)
+        {
+            for (auto& [key, value] : layer.values)
+            {
+                setOverride(values, key, std::move(value));
+            }
+
+            continue;
+        }
+
+        // Environment variable files may append elements to an array, which must happen in index order
+        std::vector<std::pair<const std::string, ConfigValue>*> entries;
+        entries.reserve(layer.values.size());
+
+        for (auto& entry : layer.values)
+        {
+            entries.push_back(&entry);
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const auto* lhs, const auto* rhs)
+                  { return ConfigStore::compareKeys(lhs->first, rhs->first) < 0; });
+
+        for (auto* entry : entries)
+        {
+            setOverride(values, entry->first, std::move(entry->second));
+        }
+    }
+}
+
+// Names of the variables mapped by environment files, which are read again only to key a new cache
+std::vector<std::string> getMappedVariableNames(const std::vector<std::filesystem::path>& filePaths)
+{
+    std::vector<std::string> names;
+
+    for (const auto& filePath : filePaths)
+    {
+        if (!ConfigFileLoader::isEnvironmentFile(filePath))
+        {
+            continue;
+        }
+
+        std::unordered_map<std::string, ConfigValue> mappedVariables;
+        BorrowedStrings borrowedStrings;
+        ConfigFileLoader::loadConfigFile(filePath, mappedVariables, borrowedStrings);
+
+        for (const auto& [key, value] : mappedVariables)
+        {
+            if (const auto* envName = std::get_if<std::string>(&value))
+            {
+                names.push_back(*envName);
+            }
+            else if (const auto* envNames = std::get_if<std::vector<std::string>>(&value))
+            {
+                names.insert(names.end(), envNames->begin(), envNames->end());
+            }
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    return names;
+}
+
+// Entries nested under a key path, all entries for an empty path
+std::span<const ConfigStore::Entry> findNestedEntries(const ConfigStore& snapshot, std::string_view keyPath)
+{
+    return keyPath.empty() ? snapshot.getEntries() : snapshot.findChildren(keyPath);
+}
+
+// Ints and bools are embedded as doubles, which hold every int exactly
+ConfigValue toConfigValue(const EmbeddedEntry& entry)
+{
+    const auto toVector = [&](auto element)
+    {
+        std::vector<decltype(element)> elements;
+        elements.reserve(entry.numbers.size());
+
+        for (const auto number : entry.numbers)
+        {
+            elements.push_back(static_cast<decltype(element)>(number));
+        }
+
+        return elements;
+    };
+
+    switch (entry.type)
+    {
+    case EmbeddedType::Null:
+        return nullptr;
+    case EmbeddedType::Bool:
+        return entry.number != 0;
+    case EmbeddedType::Int:
+        return static_cast<int>(entry.number);
+    case EmbeddedType::Float:
+        return static_cast<float>(entry.number);
+    case EmbeddedType::Double:
+        return entry.number;
+    case EmbeddedType::String:
+        return std::string{entry.text};
+    case EmbeddedType::StringArray:
+        return std::vector<std::string>(entry.texts.begin(), entry.texts.end());
+    case EmbeddedType::IntArray:
+        return toVector(0);
+    case EmbeddedType::DoubleArray:
+        return std::vector<double>(entry.numbers.begin(), entry.numbers.end());
+    case EmbeddedType::BoolArray:
+        return toVector(false);
+    }
+
+    throw std::runtime_error("Unknown type of embedded config key: " + std::string{entry.key});
+}
+}
+
+Config::Config(std::pmr::memory_resource* memoryResource) : memoryResource{memoryResource} {}
+
+Config::Config(const EmbeddedConfig& embeddedConfig, EmbeddedOverrides overrides,
+               std::pmr::memory_resource* memoryResource)
+    : memoryResource{memoryResource}, embeddedConfig{embeddedConfig}, embeddedOverrides{overrides}
+{
+}
+
+template <typename T>
+T Config::get(KeyPath keyPath)
+{
+    const auto& snapshot = getStore();
+
+    return getValue<T>(snapshot, snapshot.findValue(keyPath), {}, keyPath.getPath());
+}
+
+template <typename T>
+std::optional<T> Config::getOptional(KeyPath keyPath)
+{
+    const auto& snapshot = getStore();
+
+    return getOptionalValue<T>(snapshot, snapshot.findValue(keyPath), {}, keyPath.getPath());
+}
+
+template <typename T>
+T Config::getValue(const ConfigStore& snapshot, const std::optional<CompactValue>& value, std::string_view prefix,
+                   std::string_view keyPath) const
+{
+    if constexpr (std::is_same_v<T, std::vector<std::string>>)
+    {
+        // Arrays of objects and scalars written as separate keys are collected from the children of the key
+        if (!value || !value->isArray() || value->getType() == CompactValue::Type::ObjectArray)
+        {
+            return getArray(snapshot, joinKeyPath(prefix, keyPath));
+        }
+    }
+
+    if (!value)
+    {
+        const auto fullKeyPath = joinKeyPath(prefix, keyPath);
+        std::string errorMsg = "Configuration key '" + fullKeyPath + "' not found.";
+        std::string similar = getSimilarKeys(snapshot, fullKeyPath);
+        if (!similar.empty())
+        {
+            errorMsg += " Did you mean: " + similar + "?";
+        }
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    if (value->isNull())
+    {
+        std::string errorMsg = "Configuration key '" + joinKeyPath(prefix, keyPath) + "' has null value.";
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    std::optional<T> castedValue = config::cast<T>(*value);
+
+    if (castedValue)
+    {
+        return castedValue.value();
+    }
+    else
+    {
+        std::string errorMsg = "Configuration key '" + joinKeyPath(prefix, keyPath) +
+                               "' has wrong type. Expected: " + typeid(T).name() + ", Actual: " + getTypeString(*value);
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+template <typename T>
+std::optional<T> Config::getOptionalValue(const ConfigStore& snapshot, const std::optional<CompactValue>& value,
+                                          std::string_view prefix, std::string_view keyPath) const
+{
+    if constexpr (std::is_same_v<T, std::vector<std::string>>)
+    {
+        if (!value || !value->isArray() || value->getType() == CompactValue::Type::ObjectArray)
+        {
+            return getArray(snapshot, joinKeyPath(prefix, keyPath));
+        }
+    }
+
+    if (!value)
+    {
+        return std::nullopt;
+    }
+
+    if (value->isNull())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<T> castedValue = config::cast<T>(*value);
+
+    if (castedValue)
+    {
+        return castedValue.value();
+    }
+    else
+    {
+        std::string errorMsg = "Configuration key '" + joinKeyPath(prefix, keyPath) +
+                               "' has wrong type. Expected: " + typeid(T).name() + ", Actual: " + getTypeString(*value);
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+}
+
+template <typename T>
+T Config::getOrDefault(KeyPath keyPath, T defaultValue)
+{
+    auto optValue = getOptional<T>(keyPath);
+    return optValue.value_or(defaultValue);
+}
+
+ConfigValue Config::get(KeyPath keyPath)
+{
+    const auto& snapshot = getStore();
+
+    const auto value = snapshot.findValue(keyPath);
+    const auto children = snapshot.findChildren(keyPath.getPath());
+
+    const auto keyOccurrences = children.size() + (value ? 1 : 0);
+
+    if (keyOccurrences == 0)
+    {
+        std::string errorMsg = "Configuration key '" + std::string{keyPath.getPath()} + "' not found.";
+        std::string similar = getSimilarKeys(snapshot, keyPath.getPath());
+        if (!similar.empty())
+        {
+            errorMsg += " Did you mean: " + similar + "?";
+        }
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    if (keyOccurrences > 1)
+    {
+        return getArray(snapshot, keyPath.getPath());
+    }
+
+    return value ? value->toConfigValue() : ConfigValue{};
+}
+
+std::size_t Config::size(KeyPath keyPath)
+{
+    const auto value = getStore().findValue(keyPath);
+
+    if (!value || !value->isArray())
+    {
+        std::string errorMsg = "Configuration key '" + std::string{keyPath.getPath()} + "' is not an array.";
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    return value->getArraySize();
+}
+
+ConfigElements Config::elements(KeyPath keyPath)
+{
+    const auto& snapshot = getStore();
+
+    const auto value = snapshot.findValue(keyPath);
+
+    if (!value || value->getType() != CompactValue::Type::ObjectArray)
+    {
+        std::string errorMsg = "Configuration key '" + std::string{keyPath.getPath()} + "' is not an array of objects.";
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    const auto path = keyPath.getPath();
+    const auto children = snapshot.findChildren(path);
+    const auto first = static_cast<std::size_t>(children.data() - snapshot.getEntries().data());
+    // Indices written as "[2]" are stored as ".2", one character shorter
+    const auto prefixSize = path.size() - static_cast<std::size_t>(std::count(path.begin(), path.end(), ']'));
+
+    return ConfigElements{*this, snapshot, first, first + children.size(), prefixSize, value->getArraySize()};
+}
+
+std::vector<std::string> Config::getArray(const ConfigStore& snapshot, std::string_view keyPath) const
+{
+    std::vector<std::string> result;
+
+    // Children are returned in key order, so array elements keep their source order
+    for (const auto& [key, value] : snapshot.findChildren(keyPath))
+    {
+        // Markers of nested arrays of objects only hold the number of elements
+        if (value->getType() == CompactValue::Type::ObjectArray)
+        {
+            continue;
+        }
+
+        std::optional<std::string> castedValue = config::cast<std::string>(*value);
+        if (castedValue)
+        {
+            result.push_back(castedValue.value());
+        }
+        else
+        {
+            std::string errorMsg = "Configuration key '" + std::string{keyPath} + "' array element has wrong type.";
+            log(LogLevel::Error, errorMsg);
+            throw std::runtime_error(errorMsg);
+        }
+    }
+
+    if (result.empty())
+    {
+        std::string errorMsg = "Configuration key '" + std::string{keyPath} + "' not found.";
+        std::string similar = getSimilarKeys(snapshot, keyPath);
+        if (!similar.empty())
+        {
+            errorMsg += " Did you mean: " + similar + "?";
+        }
+        log(LogLevel::Error, errorMsg);
+        throw std::runtime_error(errorMsg);
+    }
+
+    return result;
+}
+
+ConfigView::ConfigView(const Config& config, const ConfigStore& store, std::size_t first, std::size_t last,
+                       std::size_t prefixSize)
+    : config{&config}, store{&store}, first{first}, last{last}, prefixSize{prefixSize}
+{
+}
+
+template <typename T>
+T ConfigView::get(KeyPath keyPath) const
+{
+    return config->getValue<T>(*store, findValue(keyPath.getPath()), getKeyPath(), keyPath.getPath());
+}
+
+template <typename T>
+std::optional<T> ConfigView::getOptional(KeyPath keyPath) const
+{
+    return config->getOptionalValue<T>(*store, findValue(keyPath.getPath()), getKeyPath(), keyPath.getPath());
+}
+
+bool ConfigView::has(KeyPath keyPath) const
+{
+    return findValue(keyPath.getPath()).has_value() ||
+           !store->findSubtree(store->getEntries().subspan(first, last - first), prefixSize, keyPath.getPath()).empty();
+}
+
+ConfigView ConfigView::view(KeyPath keyPath) const
+{
+    if (auto nested = findView(keyPath.getPath()))
+    {
+        return *nested;
+    }
+
+    config->throwNoNestedKeys(*store, Config::joinKeyPath(getKeyPath(), keyPath.getPath()));
+}
+
+ConfigChildren ConfigView::children() const
+{
+    return ConfigChildren{*store, first, last, prefixSize};
+}
+
+std::string_view ConfigView::getKeyPath() const
+{
+    return store->getEntries()[first].key.substr(0, prefixSize);
+}
+
+std::optional<CompactValue> ConfigView::findValue(std::string_view keyPath) const
+{
+    return store->findValue(store->getEntries().subspan(first, last - first), prefixSize, keyPath);
+}
+
+std::optional<ConfigView> ConfigView::findView(std::string_view keyPath) const
+{
+    std::size_t nestedPrefixSize = 0;
+    const auto subtree =
+        store->findNested(store->getEntries().subspan(first, last - first), prefixSize, keyPath, nestedPrefixSize);
+
+    if (subtree.empty())
+    {
+        return std::nullopt;
+    }
+
+    const auto nestedFirst = static_cast<std::size_t>(subtree.data() - store->getEntries().data());
+
+    return ConfigView{*config, *store, nestedFirst, nestedFirst + subtree.size(), nestedPrefixSize};
+}
+
+std::optional<ConfigElements> ConfigView::findElements(std::string_view keyPath) const
+{
+    const auto value = findValue(keyPath);
+
+    if (!value || value->getType() != CompactValue::Type::ObjectArray)
+    {
+        return std::nullopt;
+    }
+
+    // The marker of an array of objects is only stored together with the keys of its elements
+    const auto elements = findView(keyPath);
+
+    return ConfigElements{*config, *store, elements->first, elements->last, elements->prefixSize,
+                          value->getArraySize()};
+}
+
+ConfigValueRef::ConfigValueRef(const Config& config, const ConfigStore& store, std::string_view keyPath,
+                               const CompactValue& value)
+    : config{&config}, store{&store}, keyPath{keyPath}, value{&value}
+{
+}
+
+template <typename T>
+T ConfigValueRef::get() const
+{
+    return config->getValue<T>(*store, *value, {}, keyPath);
+}
+
+bool ConfigValueRef::isNull() const
+{
+    return value->isNull();
+}
+
+ConfigValue ConfigValueRef::toConfigValue() const
+{
+    return value->toConfigValue();
+}
+
+ConfigKeys::ConfigKeys(const ConfigStore& store, std::size_t first, std::size_t last)
+    : store{&store}, first{first}, last{last}
+{
+}
+
+ConfigKeys::Iterator ConfigKeys::begin() const
+{
+    return Iterator{*this, first};
+}
+
+ConfigKeys::Iterator ConfigKeys::end() const
+{
+    return Iterator{*this, last};
+}
+
+ConfigKeys::Iterator::Iterator(const ConfigKeys& keys, std::size_t position)
+    : keys{&keys}, position{skipArrayMarkers(position)}
+{
+}
+
+std::string_view ConfigKeys::Iterator::operator*() const
+{
+    return keys->store->getEntries()[position].key;
+}
+
+ConfigKeys::Iterator& ConfigKeys::Iterator::operator++()
+{
+    position = skipArrayMarkers(position + 1);
+
+    return *this;
+}
+
+ConfigKeys::Iterator ConfigKeys::Iterator::operator++(int)
+{
+    auto previous = *this;
+    ++*this;
+
+    return previous;
+}
+
+// Same keys as visited by Config::forEach(), markers of arrays of objects are skipped
+std::size_t ConfigKeys::Iterator::skipArrayMarkers(std::size_t from) const
+{
+    const auto entries = keys->store->getEntries();
+
+    while (from < keys->last && entries[from].value->getType() == CompactValue::Type::ObjectArray)
+    {
+        ++from;
+    }
+
+    return from;
+}
+
+ConfigChildren::ConfigChildren(const ConfigStore& store, std::size_t first, std::size_t last, std::size_t prefixSize)
+    : store{&store}, first{first}, last{last}, prefixSize{prefixSize}
+{
+}
+
+ConfigChildren::Iterator ConfigChildren::begin() const
+{
+    return Iterator{*this, first};
+}
+
+ConfigChildren::Iterator ConfigChildren::end() const
+{
+    return Iterator{*this, last};
+}
 
-template <typename T>
-T Config::get(const std::string& keyPath)
+ConfigChildren::Iterator::Iterator(const ConfigChildren& children, std::size_t position)
+    : children{&children}, position{position}, childEnd{findChildEnd()}
 {
-    std::lock_guard<std::mutex> lockGuard(lock);
+}
 
-    if (!initialized)
-    {
-        initialize();
-        initialized = true;
-    }
+std::string_view ConfigChildren::Iterator::operator*() const
+{
+    const auto key = children->store->getEntries()[position].key;
+    const auto nameBegin = children->prefixSize == 0 ? 0 : children->prefixSize + 1;
+    const auto nameEnd = key.find('.', nameBegin);
 
-    if constexpr (std::is_same_v<T, std::vector<std::string>>)
-    {
-        return getArray(keyPath);
-    }
+    return key.substr(nameBegin, nameEnd == std::string_view::npos ? std::string_view::npos : nameEnd - nameBegin);
+}
 
-    auto it = values.find(keyPath);
-    if (it == values.end())
-    {
-        std::string errorMsg = "Configuration key '" + keyPath + "' not found.";
-        std::string similar = getSimilarKeys(keyPath);
-        if (!similar.empty())
-        {
-            errorMsg += " Did you mean: " + similar + "?";
-        }
-        log(LogLevel::Error, errorMsg);
-        throw std::runtime_error(errorMsg);
-    }
+ConfigChildren::Iterator& ConfigChildren::Iterator::operator++()
+{
+    position = childEnd;
+    childEnd = findChildEnd();
 
-    const auto& value = it->second;
+    return *this;
+}
 
-    if (value.index() == 0)
-    {
-        std::string errorMsg = "Configuration key '" + keyPath + "' has null value.";
-        log(LogLevel::Error, errorMsg);
-        throw std::runtime_error(errorMsg);
-    }
+ConfigChildren::Iterator ConfigChildren::Iterator::operator++(int)
+{
+    auto previous = *this;
+    ++*this;
 
-    std::optional<T> castedValue = config::cast<T>(value);
+    return previous;
+}
 
-    if (castedValue)
-    {
-        return castedValue.value();
-    }
-    else
+std::size_t ConfigChildren::Iterator::findChildEnd() const
+{
+    if (position == children->last)
     {
-        std::string errorMsg = "Configuration key '" + keyPath + "' has wrong type. Expected: " + typeid(T).name() +
-                               ", Actual: " + getTypeString(value);
-        log(LogLevel::Error, errorMsg);
-        throw std::runtime_error(errorMsg);
+        return position;
     }
+
+    // A child sorts right before the keys nested under it, all of them are adjacent in the sorted index
+    const auto entries = children->store->getEntries().subspan(position, children->last - position);
+
+    return position + children->store->findSubtree(entries, children->prefixSize, **this).size();
 }
 
-template <typename T>
-std::optional<T> Config::getOptional(const std::string& keyPath)
+ConfigElements::ConfigElements(const Config& config, const ConfigStore& store, std::size_t first, std::size_t last,
+                               std::size_t prefixSize, std::size_t elementCount)
+    : config{&config}, store{&store}, first{first}, last{last}, prefixSize{prefixSize}, elementCount{elementCount}
 {
-    std::lock_guard<std::mutex> lockGuard(lock);
+}
 
-    if (!initialized)
-    {
-        initialize();
-        initialized = true;
-    }
+ConfigElements::Iterator ConfigElements::begin() const
+{
+    return Iterator{*this, first};
+}
 
-    if constexpr (std::is_same_v<T, std::vector<std::string>>)
+ConfigElements::Iterator ConfigElements::end() const
+{
+    return Iterator{*this, last};
+}
+
+std::size_t ConfigElements::size() const
+{
+    return elementCount;
+}
+
+ConfigElements::Iterator::Iterator(const ConfigElements& elements, std::size_t position)
+    : elements{&elements}, position{position}, elementEnd{findElementEnd()}
+{
+}
+
+ConfigView ConfigElements::Iterator::operator*() const
+{
+    return ConfigView{*elements->config, *elements->store, position, elementEnd,
+                      elements->prefixSize + 1 + getIndex().size()};
+}
+
+ConfigElements::Iterator& ConfigElements::Iterator::operator++()
+{
+    position = elementEnd;
+    elementEnd = findElementEnd();
+
+    return *this;
+}
+
+ConfigElements::Iterator ConfigElements::Iterator::operator++(int)
+{
+    auto previous = *this;
+    ++*this;
+
+    return previous;
+}
+
+std::size_t ConfigElements::Iterator::findElementEnd() const
+{
+    if (position == elements->last)
     {
-        return getArray(keyPath);
+        return position;
     }
 
-    auto it = values.find(keyPath);
-    if (it == values.end())
+    // All keys of an element share its index segment and are adjacent in the sorted index
+    const auto entries = elements->store->getEntries().subspan(position, elements->last - position);
+
+    return position + elements->store->findSubtree(entries, elements->prefixSize, getIndex()).size();
+}
+
+std::string_view ConfigElements::Iterator::getIndex() const
+{
+    const auto key = elements->store->getEntries()[position].key;
+    const auto indexBegin = elements->prefixSize + 1;
+    const auto indexEnd = key.find('.', indexBegin);
+
+    return key.substr(indexBegin, indexEnd == std::string_view::npos ? std::string_view::npos : indexEnd - indexBegin);
+}
+
+std::optional<ConfigView> Config::findView(KeyPath keyPath)
+{
+    const auto& snapshot = getStore();
+
+    std::size_t prefixSize = 0;
+    const auto children = snapshot.findNested(snapshot.getEntries(), 0, keyPath.getPath(), prefixSize);
+
+    if (children.empty())
     {
         return std::nullopt;
     }
 
-    const auto& value = it->second;
+    const auto first = static_cast<std::size_t>(children.data() - snapshot.getEntries().data());
+
+    return ConfigView{*this, snapshot, first, first + children.size(), prefixSize};
+}
+
+ConfigKeys Config::keys(KeyPath keyPath)
+{
+    const auto& snapshot = getStore();
+
+    const auto entries = findNestedEntries(snapshot, keyPath.getPath());
+    const auto first = static_cast<std::size_t>(entries.data() - snapshot.getEntries().data());
+
+    return ConfigKeys{snapshot, first, first + entries.size()};
+}
+
+void Config::visitEntries(KeyPath keyPath, void* visitor, EntryVisitor visit)
+{
+    const auto& snapshot = getStore();
 
-    if (value.index() == 0)
+    for (const auto& [key, value] : findNestedEntries(snapshot, keyPath.getPath()))
     {
-        return std::nullopt;
+        // Markers of arrays of objects only hold the number of elements, the elements are visited as their own keys
+        if (value->getType() == CompactValue::Type::ObjectArray)
+        {
+            continue;
+        }
+
+        visit(visitor, key, ConfigValueRef{*this, snapshot, key, *value});
+    }
+}
+
+ConfigView Config::view(KeyPath keyPath)
+{
+    if (auto found = findView(keyPath))
+    {
+        return *found;
     }
 
-    std::optional<T> castedValue = config::cast<T>(value);
+    throwNoNestedKeys(getStore(), std::string{keyPath.getPath()});
+}
 
-    if (castedValue)
+void Config::throwNoNestedKeys(const ConfigStore& snapshot, const std::string& keyPath) const
+{
+    std::string errorMsg;
+
+    if (snapshot.contains(keyPath))
     {
-        return castedValue.value();
+        errorMsg = "Configuration key '" + keyPath + "' is not an object.";
     }
     else
     {
-        std::string errorMsg = "Configuration key '" + keyPath + "' has wrong type. Expected: " + typeid(T).name() +
-                               ", Actual: " + getTypeString(value);
-        log(LogLevel::Error, errorMsg);
-        throw std::runtime_error(errorMsg);
+        errorMsg = "Configuration key '" + keyPath + "' not found.";
+        std::string similar = getSimilarKeys(snapshot, keyPath);
+        if (!similar.empty())
+        {
+            errorMsg += " Did you mean: " + similar + "?";
+        }
     }
+
+    log(LogLevel::Error, errorMsg);
+    throw std::runtime_error(errorMsg);
 }
 
-template <typename T>
-T Config::getOrDefault(const std::string& keyPath, T defaultValue)
+void Config::addBindError(std::vector<std::string>& errors, std::string_view prefix, std::string_view keyPath,
+                          std::string_view problem) const
 {
-    auto optValue = getOptional<T>(keyPath);
-    return optValue.value_or(defaultValue);
+    std::string errorMsg = "Configuration key '" + joinKeyPath(prefix, keyPath) + "' " + std::string{problem} + ".";
+    log(LogLevel::Error, errorMsg);
+    errors.push_back(std::move(errorMsg));
 }
 
-ConfigValue Config::get(const std::string& keyPath)
+void Config::throwBindErrors(std::string_view keyPath, const std::vector<std::string>& errors)
 {
-    std::lock_guard<std::mutex> lockGuard(lock);
-
-    if (!initialized)
+    std::string errorMsg = "Failed to bind " + std::to_string(errors.size()) + " configuration key(s) of '" +
+                           std::string{keyPath} + "':";
+    for (const auto& error : errors)
     {
-        initialize();
-        initialized = true;
+        errorMsg += "\n - " + error;
     }
 
-    const auto keyOccurrences =
-        std::count_if(values.begin(), values.end(),
-                      [&keyPath](const auto& value)
-                      {
-                          const auto& key = value.first;
-                          // Match exact key or keys that start with keyPath followed by a dot
-                          return key == keyPath || (key.find(keyPath) == 0 && key.length() > keyPath.length() &&
-                                                    key[keyPath.length()] == '.');
-                      });
+    throw std::runtime_error(errorMsg);
+}
 
-    if (keyOccurrences == 0)
+void Config::resolveKeys()
+{
+    ConfigKeyBase::resolveAll(*this);
+}
+
+bool Config::has(KeyPath keyPath)
+{
+    return getStore().contains(keyPath);
+}
+
+void Config::load()
+{
+    getStore();
+}
+
+std::future<void> Config::loadAsync()
+{
+    return std::async(std::launch::async, [this] { load(); });
+}
+
+bool Config::isLoaded() const
+{
+    return store.load(std::memory_order_acquire) != nullptr;
+}
+
+const ConfigStore& Config::getStore()
+{
+    if (const auto* snapshot = store.load(std::memory_order_acquire)) [[likely]]
     {
-        std::string errorMsg = "Configuration key '" + keyPath + "' not found.";
-        std::string similar = getSimilarKeys(keyPath);
-        if (!similar.empty())
-        {
-            errorMsg += " Did you mean: " + similar + "?";
-        }
-        log(LogLevel::Error, errorMsg);
-        throw std::runtime_error(errorMsg);
+        return *snapshot;
     }
 
-    if (keyOccurrences > 1)
+    return loadStore();
+}
+
+const ConfigStore& Config::loadStore()
+{
+    std::lock_guard<std::mutex> lockGuard(lock);
+
+    // Another thread may have finished loading while this one was waiting for the lock
+    if (const auto* snapshot = store.load(std::memory_order_acquire))
     {
-        return getArray(keyPath);
+        return *snapshot;
     }
 
-    return values[keyPath];
+    storeOwner = getSharedStore();
+
+    store.store(storeOwner.get(), std::memory_order_release);
+
+    return *storeOwner;
 }
 
-std::vector<std::string> Config::getArray(const std::string& keyPath)
+std::shared_ptr<const ConfigStore> Config::getSharedStore() const
 {
-    std::vector<std::string> result;
+    std::filesystem::path configDirectory;
+    std::string cxxEnv;
+    std::filesystem::path canonicalDirectory;
 
-    for (const auto& pair : values)
+    // Embedded configs only look for a config directory when files are layered on top of them
+    if (!embeddedConfig || embeddedOverrides == EmbeddedOverrides::FilesAndEnvironment)
     {
-        const std::string& key = pair.first;
-        const ConfigValue& value = pair.second;
+        configDirectory = ConfigDirectoryPathResolver::getConfigDirectoryPath();
+        cxxEnv = environment::ConfigProvider::getCxxEnv();
+
+        std::error_code error;
+        canonicalDirectory = std::filesystem::weakly_canonical(configDirectory, error);
 
-        // Match keys that start with keyPath followed by a dot
-        if (key.find(keyPath) == 0 && key.length() > keyPath.length() && key[keyPath.length()] == '.')
+        if (error)
         {
-            std::optional<std::string> castedValue = config::cast<std::string>(value);
-            if (castedValue)
-            {
-                result.push_back(castedValue.value());
-            }
-            else
-            {
-                std::string errorMsg = "Configuration key '" + keyPath + "' array element has wrong type.";
-                log(LogLevel::Error, errorMsg);
-                throw std::runtime_error(errorMsg);
-            }
+            canonicalDirectory = configDirectory.lexically_normal();
         }
     }
 
-    if (result.empty())
+    SharedStoreKey key{canonicalDirectory.string(),
+                       cxxEnv,
+                       memoryResource,
+                       embeddedConfig ? embeddedConfig->getEntries().data() : nullptr,
+                       embeddedConfig ? embeddedConfig->getVariables().data() : nullptr,
+                       embeddedConfig ? std::optional{embeddedOverrides} : std::nullopt};
+
+    std::shared_ptr<SharedStore> sharedStore;
+
     {
-        std::string errorMsg = "Configuration key '" + keyPath + "' not found.";
-        std::string similar = getSimilarKeys(keyPath);
-        if (!similar.empty())
+        auto& sharedStores = getSharedStores();
+
+        std::lock_guard<std::mutex> lockGuard(sharedStores.lock);
+
+        // Entries only referenced by the registry have no loaded store and nobody loading one
+        std::erase_if(sharedStores.stores, [](const auto& entry)
+                      { return entry.second.use_count() == 1 && entry.second->store.expired(); });
+
+        auto& entry = sharedStores.stores[std::move(key)];
+
+        if (!entry)
         {
-            errorMsg += " Did you mean: " + similar + "?";
+            entry = std::make_shared<SharedStore>();
         }
-        log(LogLevel::Error, errorMsg);
-        throw std::runtime_error(errorMsg);
-    }
 
-    return result;
-}
+        sharedStore = entry;
+    }
 
-bool Config::has(const std::string& keyPath)
-{
-    std::lock_guard<std::mutex> lockGuard(lock);
+    std::lock_guard<std::mutex> lockGuard(sharedStore->lock);
 
-    if (!initialized)
+    if (auto loadedStore = sharedStore->store.lock())
     {
-        initialize();
-        initialized = true;
+        return loadedStore;
     }
 
-    return values.find(keyPath) != values.end();
+    auto loadedStore =
+        embeddedConfig ? initializeEmbedded(configDirectory, cxxEnv) : initialize(configDirectory, cxxEnv);
+
+    sharedStore->store = loadedStore;
+
+    return loadedStore;
 }
 
-void Config::initialize()
+std::shared_ptr<const ConfigStore> Config::initialize(const std::filesystem::path& configDirectory,
+                                                      const std::string& cxxEnv) const
 {
+
     // Find if no config warning is enabled or disabled
     const auto suppressWarning = std::getenv("SUPPRESS_NO_CONFIG_WARNING");
 
-    // Get the path to the configuration directory
-    const auto configDirectory = ConfigDirectoryPathResolver::getConfigDirectoryPath();
-
     // Check if the configuration directory is empty
     bool isEmpty = true;
     for (const auto& entry : std::filesystem::directory_iterator(configDirectory))
@@ -241,10 +1352,8 @@ void Config::initialize()
         {
             log(LogLevel::Warning, "No configurations found in configuration directory.");
         }
-        return;
+        return std::make_shared<const ConfigStore>(std::unordered_map<std::string, ConfigValue>{}, memoryResource);
     }
-    const auto cxxEnv = environment::ConfigProvider::getCxxEnv();
-
     log(LogLevel::Info, "Config directory: " + configDirectory.string() + " loaded.");
 
     const auto strictMode = std::getenv("CXX_CONFIG_STRICT_MODE");
@@ -254,118 +1363,129 @@ void Config::initialize()
     {
         throw std::runtime_error("ERROR: CXX_ENV must not be 'default' or 'local' under strict mode");
     }
-    std::vector<std::string> order = {"default", cxxEnv, "local", "local-" + cxxEnv, "custom-environment-variables"};
 
-    auto customFileOrder = [order](const std::filesystem::path& path1, const std::filesystem::path& path2)
-    {
-        auto filename1 = path1.stem().string();
-        auto filename2 = path2.stem().string();
+    // Unsupported files are skipped, the rest are parsed concurrently into one layer per file
+    const auto filePaths = ConfigFileLoader::getFilePaths(configDirectory, cxxEnv);
 
-        auto it1 = std::find(order.begin(), order.end(), filename1);
-        auto it2 = std::find(order.begin(), order.end(), filename2);
+    // Taken once, mapped variables are resolved without scanning the environment for each of them
+    const auto environment = environment::EnvironmentSnapshot::capture();
 
-        if (it1 == order.end() && it2 == order.end())
-        {
-            // If both filenames are not in the order list, order them alphabetically
-            return path1 < path2;
-        }
-        else if (it1 == order.end())
-        {
-            // If only path1 is not in the order list, it comes after path2
-            return false;
-        }
-        else if (it2 == order.end())
-        {
-            // If only path2 is not in the order list, it comes after path1
-            return true;
-        }
-        else
+    for (const auto& filePath : filePaths)
+    {
+        if (ConfigFileLoader::isEnvironmentFile(filePath) && filePath.stem().string() == cxxEnv)
         {
-            // If both filenames are in the order list, order them based on their position in the list
-            return std::distance(order.begin(), it1) < std::distance(order.begin(), it2);
+            foundCxxEnvFile = true;
         }
-    };
+    }
 
-    std::vector<std::filesystem::path> filePaths;
-    for (const auto& entry : std::filesystem::directory_iterator(configDirectory))
+    // With CXX_CONFIG_CACHE_DIR set, unchanged files are not parsed again when a previous load cached their values
+    const auto cacheDirectory = environment.getVariable("CXX_CONFIG_CACHE_DIR");
+    std::optional<SnapshotCache> snapshotCache;
+    std::shared_ptr<const ConfigStore> loadedStore;
+
+    if (cacheDirectory && !cacheDirectory->empty())
     {
-        if (entry.is_regular_file())
+        snapshotCache.emplace(*cacheDirectory, configDirectory, cxxEnv, filePaths);
+        loadedStore = snapshotCache->load(environment, memoryResource);
+
+        if (loadedStore)
         {
-            filePaths.push_back(entry.path());
+            log(LogLevel::Debug, "Config loaded from cache: " + snapshotCache->getFilePath().string());
         }
     }
 
-    // Sort file paths according to custom order
-    std::sort(filePaths.begin(), filePaths.end(), customFileOrder);
+    const bool loadedFromCache = loadedStore != nullptr;
 
-    for (const auto& filePath : filePaths)
+    if (!loadedFromCache)
     {
-        if (filePath.extension() == ".json")
+        BorrowedStrings borrowedStrings;
+        std::unordered_map<std::string, ConfigValue> values;
+        loadConfigFiles(filePaths, environment, values, borrowedStrings);
+        applyPrefixedEnvironmentOverrides(values, environment);
+
+        if (values.empty())
         {
-            if (filePath.string().find("environment") != std::string::npos)
-            {
-                JsonConfigLoader::loadConfigEnvFile(filePath, values);
-                if (filePath.stem().string() == cxxEnv)
-                {
-                    foundCxxEnvFile = true;
-                }
-            }
-            else
-            {
-                JsonConfigLoader::loadConfigFile(filePath, values);
-            }
+            throw std::runtime_error("Config values are empty.");
         }
-        else if (filePath.extension() == ".yaml" || filePath.extension() == ".yml")
+
+        loadedStore =
+            std::make_shared<const ConfigStore>(std::move(values), memoryResource, std::move(borrowedStrings));
+    }
+
+    if (!foundCxxEnvFile && !cxxEnv.empty() && strictMode != nullptr)
+    {
+        throw std::runtime_error("ERROR: No configuration file matching CXX_ENV");
+    }
+
+    if (snapshotCache && !loadedFromCache)
+    {
+        try
         {
-            if (filePath.string().find("environment") != std::string::npos)
-            {
-                YamlConfigLoader::loadConfigEnvFile(filePath, values);
-                if (filePath.stem().string() == cxxEnv)
-                {
-                    foundCxxEnvFile = true;
-                }
-            }
-            else
-            {
-                YamlConfigLoader::loadConfigFile(filePath, values);
-            }
+            snapshotCache->store(*loadedStore, getMappedVariableNames(filePaths), environment);
         }
-        else if (filePath.extension() == ".xml")
+        catch (const std::exception& error)
         {
-            if (filePath.string().find("environment") != std::string::npos)
-            {
-                XmlConfigLoader::loadConfigEnvFile(filePath, values);
-                if (filePath.stem().string() == cxxEnv)
-                {
-                    foundCxxEnvFile = true;
-                }
-            }
-            else
-            {
-                XmlConfigLoader::loadConfigFile(filePath, values);
-            }
+            // Without a cache the next process parses the files again, the store loaded now is still valid
+            log(LogLevel::Warning, std::string{"Failed to write config cache: "} + error.what());
         }
     }
 
-    if (values.empty())
+    return loadedStore;
+}
+
+std::shared_ptr<const ConfigStore> Config::initializeEmbedded(const std::filesystem::path& configDirectory,
+                                                              const std::string& cxxEnv) const
+{
+    std::unordered_map<std::string, ConfigValue> values;
+    values.reserve(embeddedConfig->getEntries().size());
+
+    for (const auto& entry : embeddedConfig->getEntries())
+    {
+        values.emplace(entry.key, toConfigValue(entry));
+    }
+
+    if (embeddedOverrides == EmbeddedOverrides::None)
     {
-        throw std::runtime_error("Config values are empty.");
+        return std::make_shared<const ConfigStore>(std::move(values), memoryResource);
     }
 
-    if (!foundCxxEnvFile && !cxxEnv.empty() && strictMode != nullptr)
+    const auto environment = environment::EnvironmentSnapshot::capture();
+    BorrowedStrings borrowedStrings;
+
+    if (embeddedOverrides == EmbeddedOverrides::FilesAndEnvironment)
     {
-        throw std::runtime_error("ERROR: No configuration file matching CXX_ENV");
+        loadConfigFiles(ConfigFileLoader::getFilePaths(configDirectory, cxxEnv), environment, values,
+                        borrowedStrings);
+
+        log(LogLevel::Info, "Config directory: " + configDirectory.string() + " loaded over embedded config.");
+    }
+
+    // Unset and empty variables keep the embedded value, like keys mapped by custom environment variable files
+    for (const auto& variable : embeddedConfig->getVariables())
+    {
+        const auto envValue = environment.getVariable(std::string{variable.variableName});
+
+        if (envValue && !envValue->empty())
+        {
+            setOverride(values, std::string{variable.key}, *envValue);
+        }
     }
+
+    applyPrefixedEnvironmentOverrides(values, environment);
+
+    return std::make_shared<const ConfigStore>(std::move(values), memoryResource, std::move(borrowedStrings));
 }
 
 void Config::setLogCallback(LogCallback callback)
 {
-    std::lock_guard<std::mutex> lockGuard(lock);
+    std::lock_guard<std::mutex> lockGuard(logLock);
     logCallback = std::move(callback);
 }
 
 void Config::log(LogLevel level, const std::string& message) const
 {
+    std::lock_guard<std::mutex> lockGuard(logLock);
+
     if (logCallback)
     {
         logCallback(level, message);
@@ -389,11 +1509,11 @@ void Config::log(LogLevel level, const std::string& message) const
     }
 }
 
-std::string Config::getSimilarKeys(const std::string& keyPath) const
+std::string Config::getSimilarKeys(const ConfigStore& snapshot, std::string_view keyPath) const
 {
     std::vector<std::pair<std::string, int>> similarities;
 
-    for (const auto& [key, _] : values)
+    for (const auto& [key, _] : snapshot.getEntries())
     {
         // Simple Levenshtein-like similarity check
         int distance = 0;
@@ -408,7 +1528,7 @@ std::string Config::getSimilarKeys(const std::string& keyPath) const
 
         if (distance < 5) // Only suggest if relatively similar
         {
-            similarities.push_back({key, distance});
+            similarities.push_back({std::string{key}, distance});
         }
     }
 
@@ -418,8 +1538,8 @@ std::string Config::getSimilarKeys(const std::string& keyPath) const
     }
 
     // Sort by similarity (lowest distance first)
-    std::sort(similarities.begin(), similarities.end(),
-              [](const auto& a, const auto& b) { return a.second < b.second; });
+    std::stable_sort(similarities.begin(), similarities.end(),
+                     [](const auto& a, const auto& b) { return a.second < b.second; });
 
     // Return top 3 suggestions
     std::string result;
@@ -433,8 +1553,25 @@ std::string Config::getSimilarKeys(const std::string& keyPath) const
     return result;
 }
 
-std::string Config::getTypeString(const ConfigValue& value) const
+std::string Config::joinKeyPath(std::string_view prefix, std::string_view keyPath)
+{
+    if (prefix.empty())
+    {
+        return std::string{keyPath};
+    }
+
+    return std::string{prefix} + "." + std::string{keyPath};
+}
+
+std::string Config::getTypeString(const CompactValue& compactValue) const
 {
+    if (compactValue.getType() == CompactValue::Type::ObjectArray)
+    {
+        return "array of objects";
+    }
+
+    const auto value = compactValue.toConfigValue();
+
     switch (value.index())
     {
     case 0:
@@ -451,25 +1588,105 @@ std::string Config::getTypeString(const ConfigValue& value) const
         return "float";
     case 6:
         return "vector<string>";
+    case 7:
+        return "vector<int>";
+    case 8:
+        return "vector<double>";
+    case 9:
+        return "vector<bool>";
     default:
         return "unknown";
     }
 }
 
-template int Config::get<int>(const std::string&);
-template bool Config::get<bool>(const std::string&);
-template std::string Config::get<std::string>(const std::string&);
-template std::vector<std::string> Config::get<std::vector<std::string>>(const std::string&);
-template float Config::get<float>(const std::string&);
+template int Config::get<int>(KeyPath);
+template bool Config::get<bool>(KeyPath);
+template std::string Config::get<std::string>(KeyPath);
+template std::string_view Config::get<std::string_view>(KeyPath);
+template std::vector<std::string> Config::get<std::vector<std::string>>(KeyPath);
+template float Config::get<float>(KeyPath);
+template double Config::get<double>(KeyPath);
+template std::vector<int> Config::get<std::vector<int>>(KeyPath);
+template std::vector<double> Config::get<std::vector<double>>(KeyPath);
+template std::vector<float> Config::get<std::vector<float>>(KeyPath);
+template std::vector<bool> Config::get<std::vector<bool>>(KeyPath);
+template std::span<const int> Config::get<std::span<const int>>(KeyPath);
+template std::span<const double> Config::get<std::span<const double>>(KeyPath);
+template std::span<const bool> Config::get<std::span<const bool>>(KeyPath);
+template std::span<const std::string_view> Config::get<std::span<const std::string_view>>(KeyPath);
+
+template std::optional<int> Config::getOptional<int>(KeyPath);
+template std::optional<bool> Config::getOptional<bool>(KeyPath);
+template std::optional<std::string> Config::getOptional<std::string>(KeyPath);
+template std::optional<std::string_view> Config::getOptional<std::string_view>(KeyPath);
+template std::optional<std::vector<std::string>> Config::getOptional<std::vector<std::string>>(KeyPath);
+template std::optional<float> Config::getOptional<float>(KeyPath);
+template std::optional<double> Config::getOptional<double>(KeyPath);
+template std::optional<std::vector<int>> Config::getOptional<std::vector<int>>(KeyPath);
+template std::optional<std::vector<double>> Config::getOptional<std::vector<double>>(KeyPath);
+template std::optional<std::vector<float>> Config::getOptional<std::vector<float>>(KeyPath);
+template std::optional<std::vector<bool>> Config::getOptional<std::vector<bool>>(KeyPath);
+template std::optional<std::span<const int>> Config::getOptional<std::span<const int>>(KeyPath);
+template std::optional<std::span<const double>> Config::getOptional<std::span<const double>>(KeyPath);
+template std::optional<std::span<const bool>> Config::getOptional<std::span<const bool>>(KeyPath);
+template std::optional<std::span<const std::string_view>>
+    Config::getOptional<std::span<const std::string_view>>(KeyPath);
+
+template int Config::getOrDefault<int>(KeyPath, int);
+template bool Config::getOrDefault<bool>(KeyPath, bool);
+template std::string Config::getOrDefault<std::string>(KeyPath, std::string);
+template std::string_view Config::getOrDefault<std::string_view>(KeyPath, std::string_view);
+template float Config::getOrDefault<float>(KeyPath, float);
+template double Config::getOrDefault<double>(KeyPath, double);
+template std::vector<int> Config::getOrDefault<std::vector<int>>(KeyPath, std::vector<int>);
+template std::vector<double> Config::getOrDefault<std::vector<double>>(KeyPath, std::vector<double>);
+
+template int ConfigValueRef::get<int>() const;
+template bool ConfigValueRef::get<bool>() const;
+template std::string ConfigValueRef::get<std::string>() const;
+template std::string_view ConfigValueRef::get<std::string_view>() const;
+template std::vector<std::string> ConfigValueRef::get<std::vector<std::string>>() const;
+template float ConfigValueRef::get<float>() const;
+template double ConfigValueRef::get<double>() const;
+template std::vector<int> ConfigValueRef::get<std::vector<int>>() const;
+template std::vector<double> ConfigValueRef::get<std::vector<double>>() const;
+template std::vector<float> ConfigValueRef::get<std::vector<float>>() const;
+template std::vector<bool> ConfigValueRef::get<std::vector<bool>>() const;
+template std::span<const int> ConfigValueRef::get<std::span<const int>>() const;
+template std::span<const double> ConfigValueRef::get<std::span<const double>>() const;
+template std::span<const bool> ConfigValueRef::get<std::span<const bool>>() const;
+template std::span<const std::string_view> ConfigValueRef::get<std::span<const std::string_view>>() const;
 
-template std::optional<int> Config::getOptional<int>(const std::string&);
-template std::optional<bool> Config::getOptional<bool>(const std::string&);
-template std::optional<std::string> Config::getOptional<std::string>(const std::string&);
-template std::optional<std::vector<std::string>> Config::getOptional<std::vector<std::string>>(const std::string&);
-template std::optional<float> Config::getOptional<float>(const std::string&);
+template int ConfigView::get<int>(KeyPath) const;
+template bool ConfigView::get<bool>(KeyPath) const;
+template std::string ConfigView::get<std::string>(KeyPath) const;
+template std::string_view ConfigView::get<std::string_view>(KeyPath) const;
+template std::vector<std::string> ConfigView::get<std::vector<std::string>>(KeyPath) const;
+template float ConfigView::get<float>(KeyPath) const;
+template double ConfigView::get<double>(KeyPath) const;
+template std::vector<int> ConfigView::get<std::vector<int>>(KeyPath) const;
+template std::vector<double> ConfigView::get<std::vector<double>>(KeyPath) const;
+template std::vector<float> ConfigView::get<std::vector<float>>(KeyPath) const;
+template std::vector<bool> ConfigView::get<std::vector<bool>>(KeyPath) const;
+template std::span<const int> ConfigView::get<std::span<const int>>(KeyPath) const;
+template std::span<const double> ConfigView::get<std::span<const double>>(KeyPath) const;
+template std::span<const bool> ConfigView::get<std::span<const bool>>(KeyPath) const;
+template std::span<const std::string_view> ConfigView::get<std::span<const std::string_view>>(KeyPath) const;
 
-template int Config::getOrDefault<int>(const std::string&, int);
-template bool Config::getOrDefault<bool>(const std::string&, bool);
-template std::string Config::getOrDefault<std::string>(const std::string&, std::string);
-template float Config::getOrDefault<float>(const std::string&, float);
+template std::optional<int> ConfigView::getOptional<int>(KeyPath) const;
+template std::optional<bool> ConfigView::getOptional<bool>(KeyPath) const;
+template std::optional<std::string> ConfigView::getOptional<std::string>(KeyPath) const;
+template std::optional<std::string_view> ConfigView::getOptional<std::string_view>(KeyPath) const;
+template std::optional<std::vector<std::string>> ConfigView::getOptional<std::vector<std::string>>(KeyPath) const;
+template std::optional<float> ConfigView::getOptional<float>(KeyPath) const;
+template std::optional<double> ConfigView::getOptional<double>(KeyPath) const;
+template std::optional<std::vector<int>> ConfigView::getOptional<std::vector<int>>(KeyPath) const;
+template std::optional<std::vector<double>> ConfigView::getOptional<std::vector<double>>(KeyPath) const;
+template std::optional<std::vector<float>> ConfigView::getOptional<std::vector<float>>(KeyPath) const;
+template std::optional<std::vector<bool>> ConfigView::getOptional<std::vector<bool>>(KeyPath) const;
+template std::optional<std::span<const int>> ConfigView::getOptional<std::span<const int>>(KeyPath) const;
+template std::optional<std::span<const double>> ConfigView::getOptional<std::span<const double>>(KeyPath) const;
+template std::optional<std::span<const bool>> ConfigView::getOptional<std::span<const bool>>(KeyPath) const;
+template std::optional<std::span<const std::string_view>>
+    ConfigView::getOptional<std::span<const std::string_view>>(KeyPath) const;
 }
@@ -0,0 +1,139 @@
+#include "config_file_loader.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "config_value.h"
+#include "json_config_loader.h"
+#include "xml_config_loader.h"
+#include "yaml_config_loader.h"
+
+namespace config
+{
+namespace
+{
+enum class ConfigFileFormat
+{
+    Json,
+    Yaml,
+    Xml,
+    Unsupported
+};
+
+ConfigFileFormat getConfigFileFormat(const std::filesystem::path& filePath)
+{
+    const auto extension = filePath.extension();
+
+    if (extension == ".json")
+    {
+        return ConfigFileFormat::Json;
+    }
+
+    if (extension == ".yaml" || extension == ".yml")
+    {
+        return ConfigFileFormat::Yaml;
+    }
+
+    return extension == ".xml" ? ConfigFileFormat::Xml : ConfigFileFormat::Unsupported;
+}
+}
+
+std::vector<std::filesystem::path> ConfigFileLoader::getFilePaths(const std::filesystem::path& configDirectory,
+                                                                  const std::string& cxxEnv)
+{
+    std::vector<std::string> order = {"default", cxxEnv, "local", "local-" + cxxEnv, "custom-environment-variables"};
+
+    auto customFileOrder = [order](const std::filesystem::path& path1, const std::filesystem::path& path2)
+    {
+        auto filename1 = path1.stem().string();
+        auto filename2 = path2.stem().string();
+
+        auto it1 = std::find(order.begin(), order.end(), filename1);
+        auto it2 = std::find(order.begin(), order.end(), filename2);
+
+        if (it1 == order.end() && it2 == order.end())
+        {
+            // If both filenames are not in the order list, order them alphabetically
+            return path1 < path2;
+        }
+        else if (it1 == order.end())
+        {
+            // If only path1 is not in the order list, it comes after path2
+            return false;
+        }
+        else if (it2 == order.end())
+        {
+            // If only path2 is not in the order list, it comes after path1
+            return true;
+        }
+        else
+        {
+            // If both filenames are in the order list, order them based on their position in the list
+            return std::distance(order.begin(), it1) < std::distance(order.begin(), it2);
+        }
+    };
+
+    std::vector<std::filesystem::path> filePaths;
+    for (const auto& entry : std::filesystem::directory_iterator(configDirectory))
+    {
+        if (entry.is_regular_file())
+        {
+            filePaths.push_back(entry.path());
+        }
+    }
+
+    // Sort file paths according to custom order
+    std::sort(filePaths.begin(), filePaths.end(), customFileOrder);
+
+    // Unsupported files are skipped
+    std::erase_if(filePaths, [](const std::filesystem::path& filePath)
+                  { return getConfigFileFormat(filePath) == ConfigFileFormat::Unsupported; });
+
+    return filePaths;
+}
+
+bool ConfigFileLoader::isEnvironmentFile(const std::filesystem::path& filePath)
+{
+    return filePath.string().find("environment") != std::string::npos;
+}
+
+void ConfigFileLoader::loadConfigFile(const std::filesystem::path& filePath,
+                                      std::unordered_map<std::string, ConfigValue>& values,
+                                      BorrowedStrings& borrowedStrings)
+{
+    switch (getConfigFileFormat(filePath))
+    {
+    case ConfigFileFormat::Json:
+        JsonConfigLoader::loadConfigFile(filePath, values);
+        break;
+    case ConfigFileFormat::Yaml:
+        YamlConfigLoader::loadConfigFile(filePath, values);
+        break;
+    case ConfigFileFormat::Xml:
+        XmlConfigLoader::loadConfigFile(filePath, values, borrowedStrings);
+        break;
+    case ConfigFileFormat::Unsupported:
+        break;
+    }
+}
+
+void ConfigFileLoader::loadConfigEnvFile(const std::filesystem::path& filePath,
+                                         std::unordered_map<std::string, ConfigValue>& values,
+                                         const environment::EnvironmentSnapshot& environment)
+{
+    switch (getConfigFileFormat(filePath))
+    {
+    case ConfigFileFormat::Json:
+        JsonConfigLoader::loadConfigEnvFile(filePath, values, environment);
+        break;
+    case ConfigFileFormat::Yaml:
+        YamlConfigLoader::loadConfigEnvFile(filePath, values, environment);
+        break;
+    case ConfigFileFormat::Xml:
+        XmlConfigLoader::loadConfigEnvFile(filePath, values, environment);
+        break;
+    case ConfigFileFormat::Unsupported:
+        break;
+    }
+}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config-cxx/config.h"
+
+namespace config
+{
+namespace environment
+{
+class EnvironmentSnapshot;
+}
+
+struct BorrowedStrings;
+
+/**
+ * Picks the config files of a directory and the loader of each of them by file extension.
+ *
+ * Shared by Config and the build time embedding of config directories, so both merge the same files in the same order.
+ */
+class ConfigFileLoader
+{
+public:
+    // Supported files of the directory in load order: default, CXX_ENV, local, local-CXX_ENV and
+    // custom-environment-variables, followed by any other files in alphabetical order
+    static std::vector<std::filesystem::path> getFilePaths(const std::filesystem::path& configDirectory,
+                                                           const std::string& cxxEnv);
+    // Environment files map keys to the names of the environment variables holding their values
+    static bool isEnvironmentFile(const std::filesystem::path& filePath);
+    static void loadConfigFile(const std::filesystem::path& filePath,
+                               std::unordered_map<std::string, ConfigValue>& values, BorrowedStrings& borrowedStrings);
+    static void loadConfigEnvFile(const std::filesystem::path& filePath,
+                                  std::unordered_map<std::string, ConfigValue>& values,
+                                  const environment::EnvironmentSnapshot& environment);
+};
+}
@@ -0,0 +1,133 @@
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config-cxx/config.h"
+
+namespace config
+{
+namespace
+{
+struct ConfigKeyRegistry
+{
+    std::mutex lock;
+    const ConfigKeyBase* head = nullptr;
+};
+
+ConfigKeyRegistry& getRegistry()
+{
+    // Function local static, so that keys declared at namespace scope in any translation unit can register safely
+    static ConfigKeyRegistry registry;
+    return registry;
+}
+}
+
+ConfigKeyBase::ConfigKeyBase(std::string keyPathInit, bool registeredInit)
+    : keyPath{std::move(keyPathInit)}, registered{registeredInit}
+{
+    if (!registered)
+    {
+        return;
+    }
+
+    auto& registry = getRegistry();
+
+    std::lock_guard<std::mutex> lockGuard(registry.lock);
+
+    next = registry.head;
+    if (next != nullptr)
+    {
+        next->previous = this;
+    }
+    registry.head = this;
+}
+
+ConfigKeyBase::ConfigKeyBase(const ConfigKeyBase& other) : ConfigKeyBase(other.keyPath, other.registered)
+{
+    resolved = other.resolved;
+}
+
+ConfigKeyBase& ConfigKeyBase::operator=(const ConfigKeyBase& other)
+{
+    keyPath = other.keyPath;
+    resolved = other.resolved;
+    return *this;
+}
+
+ConfigKeyBase::~ConfigKeyBase()
+{
+    if (!registered)
+    {
+        return;
+    }
+
+    auto& registry = getRegistry();
+
+    std::lock_guard<std::mutex> lockGuard(registry.lock);
+
+    if (previous != nullptr)
+    {
+        previous->next = next;
+    }
+    else
+    {
+        registry.head = next;
+    }
+
+    if (next != nullptr)
+    {
+        next->previous = previous;
+    }
+}
+
+const std::string& ConfigKeyBase::getKeyPath() const
+{
+    return keyPath;
+}
+
+bool ConfigKeyBase::isResolved() const
+{
+    return resolved;
+}
+
+void ConfigKeyBase::throwNotResolved() const
+{
+    throw std::runtime_error("Configuration key '" + keyPath + "' is not resolved.");
+}
+
+void ConfigKeyBase::resolveAll(Config& config)
+{
+    auto& registry = getRegistry();
+
+    std::lock_guard<std::mutex> lockGuard(registry.lock);
+
+    std::vector<std::string> errors;
+
+    for (const auto* key = registry.head; key != nullptr; key = key->next)
+    {
+        try
+        {
+            key->resolve(config);
+        }
+        catch (const std::runtime_error& e)
+        {
+            errors.push_back(e.what());
+        }
+    }
+
+    if (errors.empty())
+    {
+        return;
+    }
+
+    std::string errorMsg = "Failed to resolve " + std::to_string(errors.size()) + " configuration key(s):";
+    for (const auto& error : errors)
+    {
+        errorMsg += "\n - " + error;
+    }
+
+    throw std::runtime_error(errorMsg);
+}
+}
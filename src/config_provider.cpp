@@ -1,6 +1,11 @@
 #include "config_provider.h"
 
 #include <cstdlib>
+#include <string_view>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace config::environment
 {
@@ -39,4 +44,48 @@ std::optional<std::string> ConfigProvider::getCxxConfigDir()
 
     return *configPath;
 }
+
+EnvironmentSnapshot EnvironmentSnapshot::capture()
+{
+#ifdef _WIN32
+    const auto* const* entries = _environ;
+#else
+    const auto* const* entries = environ;
+#endif
+
+    EnvironmentSnapshot snapshot;
+
+    for (; entries != nullptr && *entries != nullptr; ++entries)
+    {
+        const std::string_view entry{*entries};
+        const auto separator = entry.find('=');
+
+        if (separator == std::string_view::npos)
+        {
+            continue;
+        }
+
+        // Like getenv, the first definition of a variable wins
+        snapshot.variables.try_emplace(std::string{entry.substr(0, separator)}, entry.substr(separator + 1));
+    }
+
+    return snapshot;
+}
+
+std::optional<std::string> EnvironmentSnapshot::getVariable(const std::string& envName) const
+{
+    const auto variable = variables.find(envName);
+
+    if (variable == variables.end())
+    {
+        return std::nullopt;
+    }
+
+    return variable->second;
+}
+
+const std::unordered_map<std::string, std::string>& EnvironmentSnapshot::getVariables() const
+{
+    return variables;
+}
 }
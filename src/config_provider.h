@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace config::environment
 {
@@ -12,4 +13,22 @@ public:
     static std::optional<std::string> getCxxConfigDir();
     static std::optional<std::string> parseEnvironmentVariable(const std::string& envName);
 };
+
+/**
+ * Copy of the process environment taken in one pass over environ.
+ *
+ * getenv scans the whole environment on every call, resolving many variables through one snapshot costs a single scan
+ * and one hash lookup per variable.
+ */
+class EnvironmentSnapshot
+{
+public:
+    static EnvironmentSnapshot capture();
+
+    std::optional<std::string> getVariable(const std::string& envName) const;
+    const std::unordered_map<std::string, std::string>& getVariables() const;
+
+private:
+    std::unordered_map<std::string, std::string> variables;
+};
 }
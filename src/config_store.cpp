@@ -0,0 +1,985 @@
+#include "config_store.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "binary_buffer.h"
+
+namespace config
+{
+namespace
+{
+bool isNumeric(std::string_view segment);
+int compareSegments(std::string_view lhs, std::string_view rhs);
+bool isWithinSubtree(std::string_view key, std::string_view keyPath);
+bool toDottedPath(std::string_view path, std::string& dottedPath);
+std::string_view getChildSegment(std::string_view key, std::string_view keyPath);
+std::string_view getRelativeKey(std::string_view key, std::size_t prefixSize);
+bool isWithin(std::string_view buffer, std::string_view value);
+}
+
+// Sizes of the buffers of a store, in elements
+struct ConfigStore::BufferSizes
+{
+    std::size_t getArenaSize() const;
+
+    std::size_t keysSize = 0;
+    std::size_t stringsSize = 0;
+    std::size_t stringArrayElementsSize = 0;
+    std::size_t intArrayElementsSize = 0;
+    std::size_t doubleArrayElementsSize = 0;
+    std::size_t boolArrayElementsSize = 0;
+    std::size_t entriesSize = 0;
+    std::size_t capacity = 2;
+};
+
+struct ConfigStore::Layout : BufferSizes
+{
+    // A key to store, array markers have no value and only record the number of elements stored under the key
+    struct Item
+    {
+        std::string_view key;
+        const ConfigValue* value;
+        std::uint32_t elementCount;
+    };
+
+    Layout(std::unordered_map<std::string, ConfigValue> values, std::pmr::memory_resource* memoryResource,
+           BorrowedStrings borrowedStrings);
+
+    void intern(const std::string& stringValue);
+    void addArrayMarkers();
+    std::optional<std::string_view> findBorrowedString(const Item& item) const;
+
+    std::unordered_map<std::string, ConfigValue> values;
+    BorrowedStrings borrowedStrings;
+
+    // Scratch allocations are only needed while the store is frozen and are released together afterwards
+    std::pmr::monotonic_buffer_resource scratch;
+    std::pmr::vector<Item> sortedValues{&scratch};
+    // Maps every distinct string value to its copy in the store, empty until the first occurrence is compacted
+    std::pmr::unordered_map<std::string_view, std::string_view> internedStrings{&scratch};
+
+    unsigned bucketShift = 63;
+};
+
+ConfigStore::Layout::Layout(std::unordered_map<std::string, ConfigValue> valuesToFreeze,
+                            std::pmr::memory_resource* memoryResource, BorrowedStrings borrowed)
+    : values{std::move(valuesToFreeze)},
+      borrowedStrings{std::move(borrowed)},
+      // A sorted item, an interned string node and its hash bucket per value fit in one scratch block
+      scratch{std::max<std::size_t>(values.size() * 128, 1024), memoryResource}
+{
+    sortedValues.reserve(values.size());
+    internedStrings.reserve(values.size());
+
+    for (const auto& value : values)
+    {
+        sortedValues.push_back({value.first, &value.second, 0});
+        keysSize += value.first.size();
+
+        if (const auto* stringValue = std::get_if<std::string>(&value.second))
+        {
+            intern(*stringValue);
+        }
+        else if (const auto* stringArray = std::get_if<std::vector<std::string>>(&value.second))
+        {
+            stringArrayElementsSize += stringArray->size();
+
+            for (const auto& element : *stringArray)
+            {
+                intern(element);
+            }
+        }
+        else if (const auto* intArray = std::get_if<std::vector<int>>(&value.second))
+        {
+            intArrayElementsSize += intArray->size();
+        }
+        else if (const auto* doubleArray = std::get_if<std::vector<double>>(&value.second))
+        {
+            doubleArrayElementsSize += doubleArray->size();
+        }
+        else if (const auto* boolArray = std::get_if<std::vector<bool>>(&value.second))
+        {
+            boolArrayElementsSize += boolArray->size();
+        }
+    }
+
+    std::sort(sortedValues.begin(), sortedValues.end(),
+              [](const Item& lhs, const Item& rhs) { return compareKeys(lhs.key, rhs.key) < 0; });
+
+    addArrayMarkers();
+    entriesSize = sortedValues.size();
+
+    // Power of two capacity with a load factor of at most 0.8, Robin Hood probing keeps probe sequences short
+    while (capacity * 4 < sortedValues.size() * 5)
+    {
+        capacity *= 2;
+        --bucketShift;
+    }
+}
+
+std::size_t ConfigStore::BufferSizes::getArenaSize() const
+{
+    // Strings reserve room for a terminator and every buffer may be padded to the alignment of its elements
+    return keysSize + stringsSize + 2 + stringArrayElementsSize * sizeof(std::string_view) +
+           intArrayElementsSize * sizeof(int) + doubleArrayElementsSize * sizeof(double) +
+           boolArrayElementsSize * sizeof(bool) + entriesSize * sizeof(Entry) + capacity * sizeof(Bucket) +
+           8 * alignof(std::max_align_t);
+}
+
+void ConfigStore::Layout::intern(const std::string& stringValue)
+{
+    if (internedStrings.try_emplace(stringValue).second)
+    {
+        stringsSize += stringValue.size();
+    }
+}
+
+std::optional<std::string_view> ConfigStore::Layout::findBorrowedString(const Item& item) const
+{
+    const auto* placeholder = item.value != nullptr ? std::get_if<std::string>(item.value) : nullptr;
+
+    // Borrowed strings stand in for empty placeholders, so other values never need a lookup
+    if (placeholder == nullptr || !placeholder->empty() || borrowedStrings.values.empty())
+    {
+        return std::nullopt;
+    }
+
+    const auto borrowedString = borrowedStrings.values.find(std::string{item.key});
+
+    if (borrowedString == borrowedStrings.values.end())
+    {
+        return std::nullopt;
+    }
+
+    return borrowedString->second;
+}
+
+void ConfigStore::Layout::addArrayMarkers()
+{
+    struct ArrayCandidate
+    {
+        std::uint32_t elementCount = 0;
+        std::size_t lastIndex = 0;
+        bool contiguous = true;
+    };
+
+    std::pmr::unordered_map<std::string_view, ArrayCandidate> candidates{&scratch};
+
+    // Keys are sorted segment by segment, so the indices under an array key are visited in increasing order
+    for (const auto& item : sortedValues)
+    {
+        for (auto dot = item.key.find('.'); dot != std::string_view::npos; dot = item.key.find('.', dot + 1))
+        {
+            const auto segment = item.key.substr(dot + 1, item.key.find('.', dot + 1) - dot - 1);
+
+            if (dot == 0 || !isNumeric(segment))
+            {
+                continue;
+            }
+
+            auto& candidate = candidates[item.key.substr(0, dot)];
+            std::size_t index = 0;
+
+            if (std::from_chars(segment.data(), segment.data() + segment.size(), index).ec != std::errc{})
+            {
+                candidate.contiguous = false;
+            }
+            else if (candidate.elementCount == 0 || index != candidate.lastIndex)
+            {
+                candidate.contiguous = candidate.contiguous && index == candidate.elementCount;
+                candidate.lastIndex = index;
+                ++candidate.elementCount;
+            }
+        }
+    }
+
+    const auto markersBegin = sortedValues.size();
+
+    for (const auto& [key, candidate] : candidates)
+    {
+        const auto subtree = std::lower_bound(sortedValues.begin(), sortedValues.begin() + markersBegin, key,
+                                              [](const Item& item, std::string_view arrayKey)
+                                              { return compareKeys(item.key, arrayKey) < 0; });
+
+        // The key itself must not hold a value
+        if (subtree != sortedValues.begin() + markersBegin && subtree->key == key)
+        {
+            continue;
+        }
+
+        const auto subtreeEnd =
+            std::partition_point(subtree, sortedValues.begin() + markersBegin,
+                                 [key](const Item& item) { return isWithinSubtree(item.key, key); });
+
+        // Only keys whose children are exactly the indices 0..n-1 are arrays
+        if (!candidate.contiguous || subtree == subtreeEnd || !isNumeric(getChildSegment(subtree->key, key)) ||
+            !isNumeric(getChildSegment((subtreeEnd - 1)->key, key)))
+        {
+            continue;
+        }
+
+        sortedValues.push_back({key, nullptr, candidate.elementCount});
+        keysSize += key.size();
+    }
+
+    const auto compareItems = [](const Item& lhs, const Item& rhs) { return compareKeys(lhs.key, rhs.key) < 0; };
+
+    std::sort(sortedValues.begin() + static_cast<std::ptrdiff_t>(markersBegin), sortedValues.end(), compareItems);
+    std::inplace_merge(sortedValues.begin(), sortedValues.begin() + static_cast<std::ptrdiff_t>(markersBegin),
+                       sortedValues.end(), compareItems);
+}
+
+ConfigStore::ConfigStore(std::unordered_map<std::string, ConfigValue> values,
+                         std::pmr::memory_resource* memoryResource, BorrowedStrings borrowedStrings)
+    : ConfigStore{Layout{std::move(values), memoryResource, std::move(borrowedStrings)}, memoryResource}
+{
+}
+
+ConfigStore::ConfigStore(Layout&& layout, std::pmr::memory_resource* memoryResource)
+    : arena{layout.getArenaSize(), memoryResource},
+      bucketShift{layout.bucketShift},
+      borrowedStringOwners{std::move(layout.borrowedStrings.owners)}
+{
+    // Buffers are reserved up front, so views into them stay valid while they are filled
+    buckets.resize(layout.capacity);
+    keys.reserve(layout.keysSize);
+    strings.reserve(layout.stringsSize);
+    stringArrayElements.reserve(layout.stringArrayElementsSize);
+    intArrayElements.reserve(layout.intArrayElementsSize);
+    doubleArrayElements.reserve(layout.doubleArrayElementsSize);
+    boolArrayElements = {std::pmr::polymorphic_allocator<bool>{&arena}.allocate(layout.boolArrayElementsSize),
+                         layout.boolArrayElementsSize};
+
+    for (const auto& item : layout.sortedValues)
+    {
+        CompactValue value;
+
+        if (item.value == nullptr)
+        {
+            value = CompactValue::fromObjectArray(item.elementCount);
+        }
+        else if (const auto borrowedString = layout.findBorrowedString(item))
+        {
+            value = CompactValue::fromString(*borrowedString);
+        }
+        else
+        {
+            value = compact(*item.value, layout);
+        }
+
+        insert({KeyPath::hashPath(item.key), static_cast<std::uint32_t>(keys.size()),
+                static_cast<std::uint32_t>(item.key.size()), value});
+
+        keys += item.key;
+    }
+
+    // Buckets are not moved anymore, so the sorted index can point at their values
+    entries.resize(layout.sortedValues.size());
+
+    for (const auto& bucket : buckets)
+    {
+        if (bucket.keyOffset != emptyBucket)
+        {
+            const auto entryIndex = static_cast<std::size_t>(
+                std::lower_bound(layout.sortedValues.begin(), layout.sortedValues.end(), getKey(bucket),
+                                 [](const Layout::Item& item, std::string_view key)
+                                 { return compareKeys(item.key, key) < 0; }) -
+                layout.sortedValues.begin());
+
+            entries[entryIndex] = {getKey(bucket), &bucket.value};
+        }
+    }
+}
+
+ConfigStore::ConfigStore(BinaryReader& image, std::pmr::memory_resource* memoryResource)
+    : ConfigStore{readBufferSizes(image), image, memoryResource}
+{
+}
+
+ConfigStore::ConfigStore(const BufferSizes& sizes, BinaryReader& image, std::pmr::memory_resource* memoryResource)
+    : arena{sizes.getArenaSize(), memoryResource},
+      bucketShift{static_cast<unsigned>(64 - std::countr_zero(sizes.capacity))}
+{
+    keys.assign(image.readBytes(sizes.keysSize));
+    strings.assign(image.readBytes(sizes.stringsSize));
+
+    stringArrayElements.reserve(sizes.stringArrayElementsSize);
+
+    for (std::size_t index = 0; index < sizes.stringArrayElementsSize; ++index)
+    {
+        const auto offset = image.read<std::uint32_t>();
+        const auto size = image.read<std::uint32_t>();
+
+        if (std::size_t{offset} + size > strings.size())
+        {
+            throw std::runtime_error("Invalid string array element in config store image");
+        }
+
+        stringArrayElements.push_back(std::string_view{strings}.substr(offset, size));
+    }
+
+    const auto readElements = [&image](auto& elements, std::size_t size)
+    {
+        using Element = typename std::decay_t<decltype(elements)>::value_type;
+
+        const auto bytes = image.readBytes(size * sizeof(Element));
+        elements.resize(size);
+        std::memcpy(elements.data(), bytes.data(), bytes.size());
+    };
+
+    readElements(intArrayElements, sizes.intArrayElementsSize);
+    readElements(doubleArrayElements, sizes.doubleArrayElementsSize);
+
+    boolArrayElements = {std::pmr::polymorphic_allocator<bool>{&arena}.allocate(sizes.boolArrayElementsSize),
+                         sizes.boolArrayElementsSize};
+    boolArrayElementsSize = sizes.boolArrayElementsSize;
+
+    for (auto& element : boolArrayElements)
+    {
+        element = image.read<std::uint8_t>() != 0;
+    }
+
+    buckets.resize(sizes.capacity);
+
+    for (auto& bucket : buckets)
+    {
+        bucket.hash = image.read<std::uint64_t>();
+        bucket.keyOffset = image.read<std::uint32_t>();
+        bucket.keySize = image.read<std::uint32_t>();
+        bucket.value = readValue(image);
+
+        if (bucket.keyOffset != emptyBucket && std::size_t{bucket.keyOffset} + bucket.keySize > keys.size())
+        {
+            throw std::runtime_error("Invalid key in config store image");
+        }
+    }
+
+    entries.reserve(sizes.entriesSize);
+
+    for (std::size_t index = 0; index < sizes.entriesSize; ++index)
+    {
+        const auto bucketIndex = image.read<std::uint32_t>();
+
+        if (bucketIndex >= buckets.size() || buckets[bucketIndex].keyOffset == emptyBucket)
+        {
+            throw std::runtime_error("Invalid entry in config store image");
+        }
+
+        entries.push_back({getKey(buckets[bucketIndex]), &buckets[bucketIndex].value});
+    }
+}
+
+ConfigStore::BufferSizes ConfigStore::readBufferSizes(BinaryReader& image)
+{
+    BufferSizes sizes;
+    sizes.keysSize = image.read<std::uint32_t>();
+    sizes.stringsSize = image.read<std::uint32_t>();
+    sizes.stringArrayElementsSize = image.readCount(2 * sizeof(std::uint32_t));
+    sizes.intArrayElementsSize = image.readCount(sizeof(int));
+    sizes.doubleArrayElementsSize = image.readCount(sizeof(double));
+    sizes.boolArrayElementsSize = image.readCount(sizeof(std::uint8_t));
+    sizes.entriesSize = image.readCount(sizeof(std::uint32_t));
+    sizes.capacity = image.readCount(sizeof(Bucket::hash));
+
+    if (!std::has_single_bit(sizes.capacity) || sizes.capacity < 2 || sizes.entriesSize > sizes.capacity)
+    {
+        throw std::runtime_error("Invalid bucket count in config store image");
+    }
+
+    return sizes;
+}
+
+void ConfigStore::write(BinaryWriter& image) const
+{
+    // Borrowed strings are appended to the copy of the strings buffer, the image never refers to other files
+    std::string borrowedStrings;
+
+    for (const auto& bucket : buckets)
+    {
+        if (bucket.value.getType() == CompactValue::Type::String && !isWithin(strings, bucket.value.asString()))
+        {
+            borrowedStrings += bucket.value.asString();
+        }
+    }
+
+    image.write(static_cast<std::uint32_t>(keys.size()));
+    image.write(static_cast<std::uint32_t>(strings.size() + borrowedStrings.size()));
+    image.write(static_cast<std::uint32_t>(stringArrayElements.size()));
+    image.write(static_cast<std::uint32_t>(intArrayElements.size()));
+    image.write(static_cast<std::uint32_t>(doubleArrayElements.size()));
+    image.write(static_cast<std::uint32_t>(boolArrayElements.size()));
+    image.write(static_cast<std::uint32_t>(entries.size()));
+    image.write(static_cast<std::uint32_t>(buckets.size()));
+
+    image.writeBytes(keys);
+    image.writeBytes(strings);
+    image.writeBytes(borrowedStrings);
+
+    for (const auto element : stringArrayElements)
+    {
+        image.write(static_cast<std::uint32_t>(element.data() - strings.data()));
+        image.write(static_cast<std::uint32_t>(element.size()));
+    }
+
+    image.writeBytes({reinterpret_cast<const char*>(intArrayElements.data()), intArrayElements.size() * sizeof(int)});
+    image.writeBytes(
+        {reinterpret_cast<const char*>(doubleArrayElements.data()), doubleArrayElements.size() * sizeof(double)});
+
+    for (const bool element : boolArrayElements)
+    {
+        image.write(static_cast<std::uint8_t>(element));
+    }
+
+    auto borrowedStringsOffset = static_cast<std::uint32_t>(strings.size());
+
+    for (const auto& bucket : buckets)
+    {
+        image.write(bucket.hash);
+        image.write(bucket.keyOffset);
+        image.write(bucket.keySize);
+        writeValue(image, bucket.value, borrowedStringsOffset);
+    }
+
+    for (const auto& entry : entries)
+    {
+        // Entries point at the value inside their bucket
+        const auto valueOffset =
+            reinterpret_cast<const char*>(entry.value) - reinterpret_cast<const char*>(&buckets.front().value);
+        image.write(static_cast<std::uint32_t>(static_cast<std::size_t>(valueOffset) / sizeof(Bucket)));
+    }
+}
+
+void ConfigStore::writeValue(BinaryWriter& image, const CompactValue& value,
+                             std::uint32_t& borrowedStringsOffset) const
+{
+    // Scalars are written as their bits, strings and arrays as the offset of their first element
+    std::uint32_t size = 0;
+    std::uint64_t payload = 0;
+
+    switch (value.getType())
+    {
+    case CompactValue::Type::Null:
+        break;
+    case CompactValue::Type::Bool:
+        payload = value.asBool();
+        break;
+    case CompactValue::Type::Int:
+        payload = static_cast<std::uint32_t>(value.asInt());
+        break;
+    case CompactValue::Type::Double:
+        payload = std::bit_cast<std::uint64_t>(value.asDouble());
+        break;
+    case CompactValue::Type::Float:
+        payload = std::bit_cast<std::uint32_t>(value.asFloat());
+        break;
+    case CompactValue::Type::String:
+    {
+        const auto stringValue = value.asString();
+        size = static_cast<std::uint32_t>(stringValue.size());
+
+        if (!isWithin(strings, stringValue))
+        {
+            payload = borrowedStringsOffset;
+            borrowedStringsOffset += size;
+        }
+        else
+        {
+            payload = static_cast<std::uint64_t>(stringValue.data() - strings.data());
+        }
+
+        break;
+    }
+    case CompactValue::Type::StringArray:
+        size = static_cast<std::uint32_t>(value.getArraySize());
+        payload = static_cast<std::uint64_t>(value.asStringArray().data() - stringArrayElements.data());
+        break;
+    case CompactValue::Type::IntArray:
+        size = static_cast<std::uint32_t>(value.getArraySize());
+        payload = static_cast<std::uint64_t>(value.asIntArray().data() - intArrayElements.data());
+        break;
+    case CompactValue::Type::DoubleArray:
+        size = static_cast<std::uint32_t>(value.getArraySize());
+        payload = static_cast<std::uint64_t>(value.asDoubleArray().data() - doubleArrayElements.data());
+        break;
+    case CompactValue::Type::BoolArray:
+        size = static_cast<std::uint32_t>(value.getArraySize());
+        payload = static_cast<std::uint64_t>(value.asBoolArray().data() - boolArrayElements.data());
+        break;
+    case CompactValue::Type::ObjectArray:
+        size = static_cast<std::uint32_t>(value.getArraySize());
+        break;
+    }
+
+    image.write(static_cast<std::uint8_t>(value.getType()));
+    image.write(size);
+    image.write(payload);
+}
+
+CompactValue ConfigStore::readValue(BinaryReader& image) const
+{
+    const auto type = image.read<std::uint8_t>();
+    const auto size = image.read<std::uint32_t>();
+    const auto payload = image.read<std::uint64_t>();
+
+    const auto getElements = [size, payload](auto elements) -> decltype(elements)
+    {
+        if (payload > elements.size() || size > elements.size() - payload)
+        {
+            throw std::runtime_error("Invalid array in config store image");
+        }
+
+        return elements.subspan(static_cast<std::size_t>(payload), size);
+    };
+
+    switch (static_cast<CompactValue::Type>(type))
+    {
+    case CompactValue::Type::Null:
+        return {};
+    case CompactValue::Type::Bool:
+        return CompactValue::fromBool(payload != 0);
+    case CompactValue::Type::Int:
+        return CompactValue::fromInt(static_cast<int>(static_cast<std::uint32_t>(payload)));
+    case CompactValue::Type::Double:
+        return CompactValue::fromDouble(std::bit_cast<double>(payload));
+    case CompactValue::Type::Float:
+        return CompactValue::fromFloat(std::bit_cast<float>(static_cast<std::uint32_t>(payload)));
+    case CompactValue::Type::String:
+    {
+        const auto characters = getElements(std::span<const char>{strings});
+        return CompactValue::fromString({characters.data(), characters.size()});
+    }
+    case CompactValue::Type::StringArray:
+        return CompactValue::fromStringArray(getElements(std::span<const std::string_view>{stringArrayElements}));
+    case CompactValue::Type::IntArray:
+        return CompactValue::fromIntArray(getElements(std::span<const int>{intArrayElements}));
+    case CompactValue::Type::DoubleArray:
+        return CompactValue::fromDoubleArray(getElements(std::span<const double>{doubleArrayElements}));
+    case CompactValue::Type::BoolArray:
+        return CompactValue::fromBoolArray(getElements(std::span<const bool>{boolArrayElements}));
+    case CompactValue::Type::ObjectArray:
+        return CompactValue::fromObjectArray(size);
+    }
+
+    throw std::runtime_error("Invalid value type in config store image");
+}
+
+const CompactValue* ConfigStore::find(const KeyPath& keyPath) const
+{
+    const auto hash = keyPath.getHash();
+    const auto mask = buckets.size() - 1;
+
+    auto bucketIndex = getHomeBucket(hash);
+
+    for (std::size_t probeDistance = 0;; ++probeDistance)
+    {
+        const auto& bucket = buckets[bucketIndex];
+
+        // Robin Hood invariant: the key would have displaced any bucket that is closer to its home
+        if (bucket.keyOffset == emptyBucket || getProbeDistance(bucket, bucketIndex) < probeDistance)
+        {
+            return nullptr;
+        }
+
+        if (bucket.hash == hash && getKey(bucket) == keyPath.getPath())
+        {
+            return &bucket.value;
+        }
+
+        bucketIndex = (bucketIndex + 1) & mask;
+    }
+}
+
+std::span<const ConfigStore::Entry> ConfigStore::findChildren(std::string_view keyPath) const
+{
+    std::size_t nestedPrefixSize = 0;
+
+    return keyPath.empty() ? std::span<const Entry>{} : findNested(entries, 0, keyPath, nestedPrefixSize);
+}
+
+std::span<const ConfigStore::Entry> ConfigStore::findSubtree(std::span<const Entry> subtree, std::size_t prefixSize,
+                                                          std::string_view keyPath) const
+{
+    std::string dottedPath;
+
+    if (keyPath.find('[') != std::string_view::npos)
+    {
+        if (!toDottedPath(keyPath, dottedPath))
+        {
+            return {};
+        }
+
+        keyPath = dottedPath;
+    }
+
+    const auto begin = std::lower_bound(subtree.begin(), subtree.end(), keyPath,
+                                        [prefixSize](const Entry& entry, std::string_view key)
+                                        { return compareKeys(getRelativeKey(entry.key, prefixSize), key) < 0; });
+
+    const auto end = std::partition_point(begin, subtree.end(),
+                                          [prefixSize, keyPath](const Entry& entry)
+                                          {
+                                              const auto relativeKey = getRelativeKey(entry.key, prefixSize);
+                                              return relativeKey == keyPath || isWithinSubtree(relativeKey, keyPath);
+                                          });
+
+    return {begin, end};
+}
+
+std::span<const ConfigStore::Entry> ConfigStore::findNested(std::span<const Entry> subtree, std::size_t prefixSize,
+                                                         std::string_view keyPath, std::size_t& nestedPrefixSize) const
+{
+    std::string dottedPath;
+
+    if (keyPath.find('[') != std::string_view::npos)
+    {
+        if (!toDottedPath(keyPath, dottedPath))
+        {
+            return {};
+        }
+
+        keyPath = dottedPath;
+    }
+
+    if (keyPath.empty())
+    {
+        nestedPrefixSize = prefixSize;
+        return subtree;
+    }
+
+    auto nested = findSubtree(subtree, prefixSize, keyPath);
+    nestedPrefixSize = (prefixSize == 0 ? 0 : prefixSize + 1) + keyPath.size();
+
+    // The key itself sorts right before its descendants
+    if (!nested.empty() && nested.front().key.size() == nestedPrefixSize)
+    {
+        nested = nested.subspan(1);
+    }
+
+    return nested;
+}
+
+std::optional<CompactValue> ConfigStore::findValue(const KeyPath& keyPath) const
+{
+    if (const auto* value = find(keyPath))
+    {
+        return *value;
+    }
+
+    return findIndexedValue(keyPath.getPath(), [this](std::string_view path) { return find(path); });
+}
+
+std::optional<CompactValue> ConfigStore::findValue(std::span<const Entry> subtree, std::size_t prefixSize,
+                                                   std::string_view keyPath) const
+{
+    const auto findRelative = [this, subtree, prefixSize](std::string_view path) -> const CompactValue*
+    {
+        const auto range = findSubtree(subtree, prefixSize, path);
+
+        return !range.empty() && getRelativeKey(range.front().key, prefixSize) == path ? range.front().value : nullptr;
+    };
+
+    if (const auto* value = findRelative(keyPath))
+    {
+        return *value;
+    }
+
+    return findIndexedValue(keyPath, findRelative);
+}
+
+template <typename Find>
+std::optional<CompactValue> ConfigStore::findIndexedValue(std::string_view path, const Find& find) const
+{
+    std::string dottedPath;
+
+    if (path.find('[') != std::string_view::npos)
+    {
+        if (!toDottedPath(path, dottedPath))
+        {
+            return std::nullopt;
+        }
+
+        if (const auto* value = find(dottedPath))
+        {
+            return *value;
+        }
+
+        path = dottedPath;
+    }
+
+    // A numeric last segment addresses an element of the array stored under the parent key
+    const auto lastDot = path.rfind('.');
+
+    if (lastDot == std::string_view::npos || !isNumeric(path.substr(lastDot + 1)))
+    {
+        return std::nullopt;
+    }
+
+    const auto* array = find(path.substr(0, lastDot));
+    std::size_t index = 0;
+
+    const auto indexSegment = path.substr(lastDot + 1);
+
+    if (array == nullptr ||
+        std::from_chars(indexSegment.data(), indexSegment.data() + indexSegment.size(), index).ec != std::errc{})
+    {
+        return std::nullopt;
+    }
+
+    return array->getElement(index);
+}
+
+bool ConfigStore::contains(const KeyPath& keyPath) const
+{
+    return findValue(keyPath).has_value() || !findChildren(keyPath.getPath()).empty();
+}
+
+std::span<const ConfigStore::Entry> ConfigStore::getEntries() const
+{
+    return entries;
+}
+
+bool ConfigStore::empty() const
+{
+    return entries.empty();
+}
+
+int ConfigStore::compareKeys(std::string_view lhs, std::string_view rhs)
+{
+    while (true)
+    {
+        const auto lhsDot = lhs.find('.');
+        const auto rhsDot = rhs.find('.');
+
+        const auto result = compareSegments(lhs.substr(0, lhsDot), rhs.substr(0, rhsDot));
+
+        if (result != 0)
+        {
+            return result;
+        }
+
+        if (lhsDot == std::string_view::npos || rhsDot == std::string_view::npos)
+        {
+            // A key sorts before all keys nested under it
+            return (lhsDot == std::string_view::npos ? 0 : 1) - (rhsDot == std::string_view::npos ? 0 : 1);
+        }
+
+        lhs.remove_prefix(lhsDot + 1);
+        rhs.remove_prefix(rhsDot + 1);
+    }
+}
+
+CompactValue ConfigStore::compact(const ConfigValue& value, Layout& layout)
+{
+    const auto appendString = [this, &layout](const std::string& stringValue)
+    {
+        auto& internedString = layout.internedStrings.find(stringValue)->second;
+
+        if (internedString.data() == nullptr)
+        {
+            const auto offset = strings.size();
+            strings += stringValue;
+            internedString = std::string_view{strings}.substr(offset, stringValue.size());
+        }
+
+        return internedString;
+    };
+
+    switch (value.index())
+    {
+    case 1:
+        return CompactValue::fromBool(std::get<bool>(value));
+    case 2:
+        return CompactValue::fromInt(std::get<int>(value));
+    case 3:
+        return CompactValue::fromDouble(std::get<double>(value));
+    case 4:
+        return CompactValue::fromString(appendString(std::get<std::string>(value)));
+    case 5:
+        return CompactValue::fromFloat(std::get<float>(value));
+    case 6:
+    {
+        const auto& stringArray = std::get<std::vector<std::string>>(value);
+        const auto offset = stringArrayElements.size();
+
+        for (const auto& element : stringArray)
+        {
+            stringArrayElements.push_back(appendString(element));
+        }
+
+        return CompactValue::fromStringArray(std::span{stringArrayElements}.subspan(offset, stringArray.size()));
+    }
+    case 7:
+    {
+        const auto& intArray = std::get<std::vector<int>>(value);
+        const auto offset = intArrayElements.size();
+        intArrayElements.insert(intArrayElements.end(), intArray.begin(), intArray.end());
+        return CompactValue::fromIntArray(std::span{intArrayElements}.subspan(offset, intArray.size()));
+    }
+    case 8:
+    {
+        const auto& doubleArray = std::get<std::vector<double>>(value);
+        const auto offset = doubleArrayElements.size();
+        doubleArrayElements.insert(doubleArrayElements.end(), doubleArray.begin(), doubleArray.end());
+        return CompactValue::fromDoubleArray(std::span{doubleArrayElements}.subspan(offset, doubleArray.size()));
+    }
+    case 9:
+    {
+        const auto& boolArray = std::get<std::vector<bool>>(value);
+        const auto elements = boolArrayElements.subspan(boolArrayElementsSize, boolArray.size());
+        std::copy(boolArray.begin(), boolArray.end(), elements.begin());
+        boolArrayElementsSize += boolArray.size();
+        return CompactValue::fromBoolArray(elements);
+    }
+    default:
+        return {};
+    }
+}
+
+void ConfigStore::insert(Bucket inserted)
+{
+    const auto mask = buckets.size() - 1;
+
+    auto bucketIndex = getHomeBucket(inserted.hash);
+    std::size_t probeDistance = 0;
+
+    while (buckets[bucketIndex].keyOffset != emptyBucket)
+    {
+        const auto residentProbeDistance = getProbeDistance(buckets[bucketIndex], bucketIndex);
+
+        // Take the slot from an entry that is closer to its home bucket and continue inserting that entry
+        if (residentProbeDistance < probeDistance)
+        {
+            std::swap(buckets[bucketIndex], inserted);
+            probeDistance = residentProbeDistance;
+        }
+
+        bucketIndex = (bucketIndex + 1) & mask;
+        ++probeDistance;
+    }
+
+    buckets[bucketIndex] = inserted;
+}
+
+std::string_view ConfigStore::getKey(const Bucket& bucket) const
+{
+    return std::string_view{keys}.substr(bucket.keyOffset, bucket.keySize);
+}
+
+std::size_t ConfigStore::getHomeBucket(std::uint64_t hash) const
+{
+    // Fibonacci hashing spreads the bits of the key hash over the top bits used as the bucket index
+    return static_cast<std::size_t>((hash * 11400714819323198485ull) >> bucketShift);
+}
+
+std::size_t ConfigStore::getProbeDistance(const Bucket& bucket, std::size_t bucketIndex) const
+{
+    return (bucketIndex - getHomeBucket(bucket.hash)) & (buckets.size() - 1);
+}
+
+namespace
+{
+bool isNumeric(std::string_view segment)
+{
+    return !segment.empty() && std::all_of(segment.begin(), segment.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+// Numeric segments sort before all other segments and by value among themselves, other segments as plain strings.
+// Comparing numbers by value only when both segments are numeric would not be transitive ("2" < "10" < "1a" < "2").
+int compareSegments(std::string_view lhs, std::string_view rhs)
+{
+    const auto lhsNumeric = isNumeric(lhs);
+    const auto rhsNumeric = isNumeric(rhs);
+
+    if (lhsNumeric != rhsNumeric)
+    {
+        return lhsNumeric ? -1 : 1;
+    }
+
+    if (lhsNumeric)
+    {
+        const auto lhsDigits = lhs.substr(std::min(lhs.find_first_not_of('0'), lhs.size()));
+        const auto rhsDigits = rhs.substr(std::min(rhs.find_first_not_of('0'), rhs.size()));
+
+        if (lhsDigits.size() != rhsDigits.size())
+        {
+            return lhsDigits.size() < rhsDigits.size() ? -1 : 1;
+        }
+
+        if (const auto result = lhsDigits.compare(rhsDigits); result != 0)
+        {
+            return result < 0 ? -1 : 1;
+        }
+    }
+
+    const auto result = lhs.compare(rhs);
+
+    return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
+bool isWithinSubtree(std::string_view key, std::string_view keyPath)
+{
+    return key.size() > keyPath.size() && key.starts_with(keyPath) && key[keyPath.size()] == '.';
+}
+
+// First segment of a key below keyPath, "0" for "servers.0.host" below "servers"
+std::string_view getChildSegment(std::string_view key, std::string_view keyPath)
+{
+    const auto child = key.substr(keyPath.size() + 1);
+
+    return child.substr(0, child.find('.'));
+}
+
+// Part of a key below a prefix of prefixSize characters, "port" for "servers.0.port" below "servers.0"
+std::string_view getRelativeKey(std::string_view key, std::size_t prefixSize)
+{
+    return prefixSize == 0 ? key : key.substr(std::min(prefixSize + 1, key.size()));
+}
+
+// String values outside the strings buffer of a store are borrowed from a mapped file
+bool isWithin(std::string_view buffer, std::string_view value)
+{
+    return value.data() >= buffer.data() && value.data() + value.size() <= buffer.data() + buffer.size();
+}
+
+// Rewrites indices written as "ports[2]" into the "ports.2" segments used by the store
+bool toDottedPath(std::string_view path, std::string& dottedPath)
+{
+    dottedPath.reserve(path.size());
+
+    for (std::size_t position = 0; position < path.size(); ++position)
+    {
+        if (path[position] != '[')
+        {
+            dottedPath += path[position];
+            continue;
+        }
+
+        const auto closing = path.find(']', position);
+
+        if (closing == std::string_view::npos || !isNumeric(path.substr(position + 1, closing - position - 1)))
+        {
+            return false;
+        }
+
+        // A path relative to an array, as read from a view, may start with an index
+        if (position != 0)
+        {
+            dottedPath += '.';
+        }
+
+        dottedPath += path.substr(position + 1, closing - position - 1);
+        position = closing;
+    }
+
+    return true;
+}
+}
+}
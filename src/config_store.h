@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "compact_value.h"
+#include "config-cxx/config.h"
+#include "config_value.h"
+
+namespace config
+{
+class BinaryReader;
+class BinaryWriter;
+
+/**
+ * Immutable snapshot of merged configuration values.
+ *
+ * A store is frozen once from the values merged by Config::initialize() and never modified afterwards, so it can be
+ * shared between threads and read without any synchronization.
+ *
+ * The store is a Robin Hood open addressing table with the key hash, key location and value stored inline in each
+ * bucket, so an exact lookup touches one bucket and the key characters. Values are stored as 16 byte CompactValue,
+ * key characters, string values and array elements live in buffers owned by the store, one per element type.
+ *
+ * All buffers are carved out of a monotonic arena that is sized before the first allocation, so freezing a store
+ * requests one block from the memory resource no matter how many keys it holds. Identical string values and array
+ * elements are interned and stored once.
+ *
+ * For prefix lookups the store additionally keeps a sorted index of entries. Keys are ordered segment by segment,
+ * numeric segments before all others and compared as numbers ("roles.2" < "roles.10" < "roles.1a"), so every subtree
+ * is a contiguous range of the index and array elements are kept in their source order.
+ *
+ * find() only matches stored keys, findValue() additionally resolves an index into an array value, written either as
+ * "ports[2]" or "ports.2".
+ *
+ * Borrowed strings are not copied, their values point into the memory-mapped files the store keeps alive.
+ *
+ * write() saves the buffers of a frozen store with offsets in place of pointers. A store read back from that image
+ * copies the buffers into its arena and rebases the offsets, without sorting, hashing or interning anything again.
+ *
+ * Arrays of objects are stored as their elements' keys ("servers.0.host", "servers.1.host") plus an ObjectArray
+ * marker under the array key holding the number of elements, so the size of an array is a single lookup.
+ */
+class ConfigStore
+{
+public:
+    struct Entry
+    {
+        std::string_view key;
+        const CompactValue* value;
+    };
+
+    explicit ConfigStore(std::unordered_map<std::string, ConfigValue> values,
+                         std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource(),
+                         BorrowedStrings borrowedStrings = {});
+
+    // Reads a store saved by write(), throws std::runtime_error when the image is malformed
+    ConfigStore(BinaryReader& image, std::pmr::memory_resource* memoryResource);
+
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    const CompactValue* find(const KeyPath& keyPath) const;
+    std::optional<CompactValue> findValue(const KeyPath& keyPath) const;
+    std::span<const Entry> findChildren(std::string_view keyPath) const;
+    // Lookups relative to a range of entries sharing a key prefix of prefixSize characters, used by ConfigView.
+    // Indices may be written as "[2]" like in any other key path, a relative path may start with one.
+    std::span<const Entry> findSubtree(std::span<const Entry> subtree, std::size_t prefixSize,
+                                       std::string_view keyPath) const;
+    // Entries nested under a relative key path without the entry of the key itself, nestedPrefixSize receives the size
+    // of the stored key they are nested under
+    std::span<const Entry> findNested(std::span<const Entry> subtree, std::size_t prefixSize, std::string_view keyPath,
+                                      std::size_t& nestedPrefixSize) const;
+    std::optional<CompactValue> findValue(std::span<const Entry> subtree, std::size_t prefixSize,
+                                          std::string_view keyPath) const;
+    bool contains(const KeyPath& keyPath) const;
+    std::span<const Entry> getEntries() const;
+    bool empty() const;
+    void write(BinaryWriter& image) const;
+
+    static int compareKeys(std::string_view lhs, std::string_view rhs);
+
+private:
+    struct Bucket
+    {
+        std::uint64_t hash = 0;
+        std::uint32_t keyOffset = emptyBucket;
+        std::uint32_t keySize = 0;
+        CompactValue value;
+    };
+
+    struct BufferSizes;
+    struct Layout;
+
+    static constexpr std::uint32_t emptyBucket = UINT32_MAX;
+
+    ConfigStore(Layout&& layout, std::pmr::memory_resource* memoryResource);
+    ConfigStore(const BufferSizes& sizes, BinaryReader& image, std::pmr::memory_resource* memoryResource);
+
+    static BufferSizes readBufferSizes(BinaryReader& image);
+    CompactValue readValue(BinaryReader& image) const;
+    void writeValue(BinaryWriter& image, const CompactValue& value, std::uint32_t& borrowedStringsOffset) const;
+
+    CompactValue compact(const ConfigValue& value, Layout& layout);
+    template <typename Find>
+    std::optional<CompactValue> findIndexedValue(std::string_view path, const Find& find) const;
+    void insert(Bucket inserted);
+    std::string_view getKey(const Bucket& bucket) const;
+    std::size_t getHomeBucket(std::uint64_t hash) const;
+    std::size_t getProbeDistance(const Bucket& bucket, std::size_t bucketIndex) const;
+
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::string keys{&arena};
+    std::pmr::string strings{&arena};
+    std::pmr::vector<std::string_view> stringArrayElements{&arena};
+    std::pmr::vector<int> intArrayElements{&arena};
+    std::pmr::vector<double> doubleArrayElements{&arena};
+    // std::vector<bool> does not store bools contiguously, so they get a plain array sized up front
+    std::span<bool> boolArrayElements;
+    std::size_t boolArrayElementsSize = 0;
+    std::pmr::vector<Entry> entries{&arena};
+    std::pmr::vector<Bucket> buckets{&arena};
+    unsigned bucketShift = 63;
+    std::vector<std::shared_ptr<const void>> borrowedStringOwners;
+};
+}
@@ -0,0 +1,483 @@
+#include "config_struct_generator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "config_file_loader.h"
+#include "config_value.h"
+#include "cpp_literal.h"
+
+namespace config
+{
+namespace
+{
+// Keys named like C++ keywords get a trailing underscore
+constexpr std::string_view keywords[] = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char",
+    "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr", "constinit",
+    "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete", "do", "double",
+    "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if",
+    "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+    "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "requires", "return", "short", "signed",
+    "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw",
+    "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile",
+    "wchar_t", "while", "xor", "xor_eq"};
+
+// One segment of the schema keys. Arrays of objects have their elements merged into element, so every element is read
+// into the same struct
+struct SchemaNode
+{
+    std::optional<ConfigValue> value;
+    std::map<std::string, SchemaNode> children;
+    std::unique_ptr<SchemaNode> element;
+};
+
+struct Member
+{
+    std::string segment;
+    std::string identifier;
+    const SchemaNode* node;
+    // Type of the nested struct of objects and arrays of objects, empty for values
+    std::string structType;
+};
+
+bool isIndex(std::string_view segment)
+{
+    return !segment.empty() &&
+           std::all_of(segment.begin(), segment.end(), [](unsigned char character) { return std::isdigit(character); });
+}
+
+bool isNumber(const ConfigValue& value)
+{
+    return std::holds_alternative<int>(value) || std::holds_alternative<double>(value) ||
+           std::holds_alternative<float>(value);
+}
+
+std::string joinKeyPath(const std::string& prefix, const std::string& segment)
+{
+    return prefix.empty() ? segment : prefix + "." + segment;
+}
+
+std::string toIdentifier(std::string_view segment)
+{
+    std::string identifier;
+
+    for (const auto character : segment)
+    {
+        identifier += std::isalnum(static_cast<unsigned char>(character)) != 0 ? character : '_';
+    }
+
+    if (identifier.empty() || std::isdigit(static_cast<unsigned char>(identifier.front())) != 0)
+    {
+        identifier.insert(0, "_");
+    }
+
+    if (std::find(std::begin(keywords), std::end(keywords), identifier) != std::end(keywords))
+    {
+        identifier += '_';
+    }
+
+    return identifier;
+}
+
+// Type of the member holding a value, std::nullopt for null values
+std::optional<std::string> getMemberType(const ConfigValue& value)
+{
+    return std::visit(
+        [](const auto& typedValue) -> std::optional<std::string>
+        {
+            using T = std::decay_t<decltype(typedValue)>;
+
+            if constexpr (std::is_same_v<T, std::nullptr_t>)
+            {
+                return std::nullopt;
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                return "bool";
+            }
+            else if constexpr (std::is_same_v<T, int>)
+            {
+                return "int";
+            }
+            else if constexpr (std::is_same_v<T, float>)
+            {
+                return "float";
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                return "double";
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                return "std::string";
+            }
+            else if constexpr (std::is_same_v<T, std::vector<std::string>>)
+            {
+                return "std::vector<std::string>";
+            }
+            else if constexpr (std::is_same_v<T, std::vector<int>>)
+            {
+                return "std::vector<int>";
+            }
+            else if constexpr (std::is_same_v<T, std::vector<double>>)
+            {
+                return "std::vector<double>";
+            }
+            else
+            {
+                return "std::vector<bool>";
+            }
+        },
+        value);
+}
+
+void addKey(SchemaNode& root, const std::string& keyPath, const ConfigValue& value)
+{
+    auto* node = &root;
+    std::size_t start = 0;
+
+    while (true)
+    {
+        const auto end = keyPath.find('.', start);
+        node = &node->children[keyPath.substr(start, end - start)];
+
+        if (end == std::string::npos)
+        {
+            break;
+        }
+
+        start = end + 1;
+    }
+
+    node->value = value;
+}
+
+// Elements mixing ints and other numbers are read as doubles, null values take the type of the other elements
+void mergeElement(SchemaNode& target, const SchemaNode& source, const std::string& keyPath)
+{
+    if (source.value && !std::holds_alternative<std::nullptr_t>(*source.value))
+    {
+        if (!target.value || std::holds_alternative<std::nullptr_t>(*target.value))
+        {
+            target.value = source.value;
+        }
+        else if (target.value->index() != source.value->index())
+        {
+            if (!isNumber(*target.value) || !isNumber(*source.value))
+            {
+                throw std::runtime_error("Elements of the schema have different types at key '" + keyPath + "'.");
+            }
+
+            target.value = 0.0;
+        }
+    }
+    else if (source.value && !target.value)
+    {
+        target.value = source.value;
+    }
+
+    for (const auto& [segment, child] : source.children)
+    {
+        mergeElement(target.children[segment], child, keyPath + "." + segment);
+    }
+}
+
+// Replaces the indices of every array of objects with a single element holding the keys of all of them
+void mergeElements(SchemaNode& node, const std::string& keyPath)
+{
+    if (node.value && !node.children.empty())
+    {
+        throw std::runtime_error("Key '" + keyPath + "' is both a value and an object in the schema.");
+    }
+
+    const auto isElement = [](const auto& child) { return isIndex(child.first); };
+    const auto isObjectArray =
+        !node.children.empty() && std::all_of(node.children.begin(), node.children.end(), isElement);
+
+    if (isObjectArray)
+    {
+        node.element = std::make_unique<SchemaNode>();
+
+        for (const auto& [index, element] : node.children)
+        {
+            mergeElement(*node.element, element, keyPath + "[]");
+        }
+
+        node.children.clear();
+        mergeElements(*node.element, keyPath + "[]");
+        return;
+    }
+
+    for (auto& [segment, child] : node.children)
+    {
+        mergeElements(child, joinKeyPath(keyPath, segment));
+    }
+}
+
+// Members of the top level struct must not hide its static load(), so a key named load gets a trailing underscore
+std::vector<Member> getMembers(const SchemaNode& node, const std::string& keyPath, bool isTopLevel)
+{
+    std::vector<Member> members;
+    std::set<std::string> names;
+
+    for (const auto& [segment, child] : node.children)
+    {
+        Member member{segment, toIdentifier(segment), &child, ""};
+
+        if (isTopLevel && member.identifier == "load")
+        {
+            member.identifier += '_';
+        }
+
+        if (child.element || !child.children.empty())
+        {
+            const auto initial = static_cast<unsigned char>(member.identifier.front());
+
+            member.structType = static_cast<char>(std::toupper(initial)) + member.identifier.substr(1);
+            member.structType += child.element ? "Element" : "Section";
+        }
+
+        if (!names.insert(member.identifier).second ||
+            (!member.structType.empty() && !names.insert(member.structType).second))
+        {
+            throw std::runtime_error("Keys under '" + keyPath + "' map to the same C++ name '" + member.identifier +
+                                     "'.");
+        }
+
+        members.push_back(std::move(member));
+    }
+
+    return members;
+}
+
+void writeStruct(std::string& output, const SchemaNode& node, const std::string& typeName, const std::string& keyPath,
+                 const std::string& indent, const std::string& declarations)
+{
+    const auto members = getMembers(node, keyPath, indent.empty());
+
+    output += indent + "struct " + typeName + "\n" + indent + "{\n";
+
+    for (const auto& member : members)
+    {
+        if (!member.structType.empty())
+        {
+            const auto& structNode = member.node->element ? *member.node->element : *member.node;
+
+            writeStruct(output, structNode, member.structType, joinKeyPath(keyPath, member.segment), indent + "    ",
+                        "");
+            output += "\n";
+        }
+    }
+
+    for (const auto& member : members)
+    {
+        const auto memberIndent = indent + "    ";
+
+        if (member.node->element)
+        {
+            output += memberIndent + "std::vector<" + member.structType + "> " + member.identifier + ";\n";
+            continue;
+        }
+
+        if (!member.structType.empty())
+        {
+            output += memberIndent + member.structType + " " + member.identifier + ";\n";
+            continue;
+        }
+
+        const auto memberType = getMemberType(*member.node->value);
+
+        if (!memberType)
+        {
+            output += memberIndent + "// '" + joinKeyPath(keyPath, member.segment) +
+                      "' is null in the schema, read it with Config::get()\n";
+        }
+        else if (memberType->starts_with("std::"))
+        {
+            output += memberIndent + *memberType + " " + member.identifier + ";\n";
+        }
+        else
+        {
+            output += memberIndent + *memberType + " " + member.identifier + "{};\n";
+        }
+    }
+
+    output += declarations;
+    output += indent + "};\n";
+}
+
+// Key paths of top level members are literals, inside arrays of objects they are appended to the element prefix
+std::string toKeyPathExpression(const std::string& prefix, const std::string& relativeKeyPath)
+{
+    const auto literal = toCppStringLiteral(relativeKeyPath);
+
+    return prefix.empty() ? literal : prefix + " + " + literal;
+}
+
+void writeLoad(std::string& output, const SchemaNode& node, const std::string& object, const std::string& prefix,
+               const std::string& relativeKeyPath, const std::string& indent, std::size_t depth)
+{
+    for (const auto& member : getMembers(node, relativeKeyPath, depth == 0 && relativeKeyPath.empty()))
+    {
+        const auto memberKeyPath = relativeKeyPath + member.segment;
+        const auto field = object + "." + member.identifier;
+
+        if (member.node->element)
+        {
+            const auto index = "index" + std::to_string(depth);
+            const auto element = "element" + std::to_string(depth);
+            const auto elementPrefix = "prefix" + std::to_string(depth);
+            const auto elementIndent = indent + "    ";
+
+            output += indent + "readSize(" + field + ", " + toKeyPathExpression(prefix, memberKeyPath) + ");\n";
+            output += indent + "for (std::size_t " + index + " = 0; " + index + " < " + field + ".size(); ++" + index +
+                      ")\n";
+            output += indent + "{\n";
+            output += elementIndent + "auto& " + element + " = " + field + "[" + index + "];\n";
+            output += elementIndent + "const auto " + elementPrefix + " = " +
+                      toKeyPathExpression(prefix, memberKeyPath + ".") + " + std::to_string(" + index + ") + \".\";\n";
+
+            writeLoad(output, *member.node->element, element, elementPrefix, "", elementIndent, depth + 1);
+
+            output += indent + "}\n";
+        }
+        else if (!member.structType.empty())
+        {
+            writeLoad(output, *member.node, field, prefix, memberKeyPath + ".", indent, depth);
+        }
+        else if (getMemberType(*member.node->value))
+        {
+            output += indent + "read(" + field + ", " + toKeyPathExpression(prefix, memberKeyPath) + ");\n";
+        }
+    }
+}
+}
+
+std::string ConfigStructGenerator::generate(const std::filesystem::path& schemaFilePath, const std::string& name,
+                                            const std::string& namespaceName)
+{
+    if (toIdentifier(name) != name)
+    {
+        throw std::runtime_error("Config struct name must be a C++ identifier: " + name);
+    }
+
+    if (!std::filesystem::is_regular_file(schemaFilePath))
+    {
+        throw std::runtime_error("Config schema file not found: " + schemaFilePath.string());
+    }
+
+    std::unordered_map<std::string, ConfigValue> values;
+    BorrowedStrings borrowedStrings;
+
+    ConfigFileLoader::loadConfigFile(schemaFilePath, values, borrowedStrings);
+
+    if (values.empty())
+    {
+        throw std::runtime_error("Config schema file has no keys: " + schemaFilePath.string());
+    }
+
+    SchemaNode root;
+
+    for (const auto& [keyPath, value] : values)
+    {
+        addKey(root, keyPath, value);
+    }
+
+    mergeElements(root, "");
+
+    std::string header = "// Generated by config_cxx_struct() from " + schemaFilePath.filename().string() +
+                         ", do not edit.\n"
+                         "#pragma once\n"
+                         "\n"
+                         "#include <cstddef>\n"
+                         "#include <stdexcept>\n"
+                         "#include <string>\n"
+                         "#include <type_traits>\n"
+                         "#include <vector>\n"
+                         "\n"
+                         "#include \"config-cxx/config.h\"\n"
+                         "\n"
+                         "namespace " +
+                         namespaceName + "\n{\n";
+
+    writeStruct(header, root, name, "", "",
+                "\n"
+                "    /**\n"
+                "     * @brief Read every member from the config, all lookups and type checks are done here.\n"
+                "     *\n"
+                "     * @throws std::runtime_error listing every key that is missing or has another type.\n"
+                "     */\n"
+                "    static " +
+                    name + " load(config::Config& config);\n");
+
+    header += "\n"
+              "inline " +
+              name + " " + name +
+              "::load(config::Config& config)\n"
+              "{\n"
+              "    " +
+              name +
+              " result;\n"
+              "    std::vector<std::string> errors;\n"
+              "\n"
+              "    [[maybe_unused]] const auto read = [&](auto& field, const std::string& keyPath)\n"
+              "    {\n"
+              "        try\n"
+              "        {\n"
+              "            field = config.get<std::decay_t<decltype(field)>>(keyPath);\n"
+              "        }\n"
+              "        catch (const std::runtime_error& error)\n"
+              "        {\n"
+              "            errors.push_back(error.what());\n"
+              "        }\n"
+              "    };\n"
+              "\n"
+              "    [[maybe_unused]] const auto readSize = [&](auto& elements, const std::string& keyPath)\n"
+              "    {\n"
+              "        try\n"
+              "        {\n"
+              "            elements.resize(config.size(keyPath));\n"
+              "        }\n"
+              "        catch (const std::runtime_error& error)\n"
+              "        {\n"
+              "            errors.push_back(error.what());\n"
+              "        }\n"
+              "    };\n"
+              "\n";
+
+    writeLoad(header, root, "result", "", "", "    ", 0);
+
+    header += "\n"
+              "    if (!errors.empty())\n"
+              "    {\n"
+              "        std::string errorMsg =\n"
+              "            \"Failed to load \" + std::to_string(errors.size()) + \" configuration key(s) of " +
+              name +
+              ":\";\n"
+              "        for (const auto& error : errors)\n"
+              "        {\n"
+              "            errorMsg += \"\\n - \" + error;\n"
+              "        }\n"
+              "\n"
+              "        throw std::runtime_error(errorMsg);\n"
+              "    }\n"
+              "\n"
+              "    return result;\n"
+              "}\n"
+              "}\n";
+
+    return header;
+}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace config
+{
+/**
+ * Generates the C++ header of a typed config struct, run at build time by the config_cxx_struct() CMake function.
+ *
+ * The schema is a config file in any supported format, usually default.json, whose values give the type of each key.
+ * Objects become nested structs, arrays of objects vectors of structs, and null values are left out since their type
+ * is unknown. The generated load() reads every member from a loaded config once, so later reads are member loads and
+ * a mistyped key fails to compile.
+ */
+class ConfigStructGenerator
+{
+public:
+    // Header defining <namespaceName>::<name> with one member per key of the schema file
+    static std::string generate(const std::filesystem::path& schemaFilePath, const std::string& name,
+                                const std::string& namespaceName);
+};
+}
@@ -1,13 +1,33 @@
+#pragma once
+
 #include <cmath>
+#include <cstddef>
 #include <iomanip>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
+#include "config-cxx/config.h"
+
 namespace details
 {
+template <typename T>
+struct is_vector : std::false_type
+{
+};
+
+template <typename T>
+struct is_vector<std::vector<T>> : std::true_type
+{
+};
+
 template <typename T>
 int findDecimal(T const& t)
 {
@@ -63,6 +83,20 @@ std::optional<std::string> to_string(T const& t)
         result += "]";
         return result;
     }
+    else if constexpr (is_vector<T>::value)
+    {
+        std::string result = "[";
+        for (const auto& element : t)
+        {
+            if (result.size() > 1)
+            {
+                result += ", ";
+            }
+            result += *to_string(static_cast<typename T::value_type>(element));
+        }
+        result += "]";
+        return result;
+    }
     else if constexpr (std::is_floating_point_v<T>)
     {
         // Calculate precision dynamically based on the input value
@@ -88,6 +122,16 @@ std::optional<std::vector<std::string>> to_vector(const T& t)
 
     std::vector<std::string> result;
 
+    if constexpr (is_vector<T>::value)
+    {
+        result.reserve(t.size());
+        for (const auto& element : t)
+        {
+            result.push_back(*details::to_string(static_cast<typename T::value_type>(element)));
+        }
+        return result;
+    }
+
     auto strOption = details::to_string(t);
 
     if (strOption.has_value())
@@ -105,7 +149,13 @@ std::optional<std::vector<std::string>> to_vector(const T& t)
 template <typename T, typename U>
 std::optional<T> to_optional(U const& u)
 {
-    if constexpr (std::is_constructible_v<T, U const&>)
+    // Scalars would otherwise select the size constructor of a vector
+    if constexpr (is_vector<T>::value != is_vector<U>::value)
+        return std::nullopt;
+    else if constexpr (is_vector<T>::value && !std::is_constructible_v<T, U const&>)
+        // An empty array has no element type and converts to any array
+        return u.empty() ? std::optional<T>{T{}} : std::nullopt;
+    else if constexpr (std::is_constructible_v<T, U const&>)
         return static_cast<T>(u);
     else
         return std::nullopt;
@@ -114,8 +164,6 @@ std::optional<T> to_optional(U const& u)
 
 namespace config
 {
-using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>>;
-
 template <typename T>
 std::optional<T> cast(ConfigValue const& cv)
 {
@@ -134,4 +182,77 @@ inline std::optional<std::vector<std::string>> cast<std::vector<std::string>>(Co
     return std::visit([](auto const& value) { return details::to_vector(value); }, cv);
 }
 
+/**
+ * Picks the native array type for parsed scalar array elements: ints, numbers (stored as doubles) or bools.
+ * Returns std::nullopt for empty arrays and arrays of strings, nulls or mixed types, which loaders store as strings.
+ */
+inline std::optional<ConfigValue> toTypedArray(const std::vector<ConfigValue>& elements)
+{
+    if (elements.empty())
+    {
+        return std::nullopt;
+    }
+
+    bool allBools = true;
+    bool allInts = true;
+    bool allNumbers = true;
+
+    for (const auto& element : elements)
+    {
+        allBools = allBools && std::holds_alternative<bool>(element);
+        allInts = allInts && std::holds_alternative<int>(element);
+        allNumbers = allNumbers && (std::holds_alternative<int>(element) || std::holds_alternative<double>(element) ||
+                                    std::holds_alternative<float>(element));
+    }
+
+    if (allBools)
+    {
+        std::vector<bool> result;
+        result.reserve(elements.size());
+        for (const auto& element : elements)
+        {
+            result.push_back(std::get<bool>(element));
+        }
+        return result;
+    }
+
+    if (allInts)
+    {
+        std::vector<int> result;
+        result.reserve(elements.size());
+        for (const auto& element : elements)
+        {
+            result.push_back(std::get<int>(element));
+        }
+        return result;
+    }
+
+    if (allNumbers)
+    {
+        std::vector<double> result;
+        result.reserve(elements.size());
+        for (const auto& element : elements)
+        {
+            result.push_back(*cast<double>(element));
+        }
+        return result;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * String values left in a memory-mapped config file instead of being copied, keyed like the values they stand in for.
+ *
+ * A loader that borrows a string stores an empty string placeholder under its key and adds the mapping to owners,
+ * which keep it alive for as long as a store refers to the borrowed strings.
+ */
+struct BorrowedStrings
+{
+    // Strings of at least minSize bytes are borrowed, by default every string is copied
+    std::size_t minSize = std::numeric_limits<std::size_t>::max();
+    std::unordered_map<std::string, std::string_view> values;
+    std::vector<std::shared_ptr<const void>> owners;
+};
+
 } // namespace config
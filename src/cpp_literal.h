@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace config
+{
+/**
+ * Quotes text as a C++ string literal for generated sources. Quotes, backslashes and every byte outside printable ASCII
+ * are escaped, three digit octal escapes never absorb the characters following them.
+ */
+inline std::string toCppStringLiteral(std::string_view text)
+{
+    std::string literal = "\"";
+
+    for (const auto character : text)
+    {
+        const auto byte = static_cast<unsigned char>(character);
+
+        if (character == '"' || character == '\\')
+        {
+            literal += '\\';
+            literal += character;
+        }
+        else if (byte < 0x20 || byte >= 0x7f)
+        {
+            literal += '\\';
+            literal += static_cast<char>('0' + (byte >> 6));
+            literal += static_cast<char>('0' + ((byte >> 3) & 7));
+            literal += static_cast<char>('0' + (byte & 7));
+        }
+        else
+        {
+            literal += character;
+        }
+    }
+
+    return literal + "\"";
+}
+}
@@ -0,0 +1,315 @@
+#include "embedded_config_generator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "config_file_loader.h"
+#include "config_store.h"
+#include "config_value.h"
+#include "cpp_literal.h"
+
+namespace config
+{
+namespace
+{
+bool isIdentifier(const std::string& name)
+{
+    const auto isIdentifierCharacter = [](unsigned char character)
+    { return std::isalnum(character) != 0 || character == '_'; };
+
+    return !name.empty() && !std::isdigit(static_cast<unsigned char>(name.front())) &&
+           std::all_of(name.begin(), name.end(), isIdentifierCharacter);
+}
+
+std::string toStringLiteral(std::string_view text)
+{
+    return toCppStringLiteral(text) + "sv";
+}
+
+// Shortest text that parses back to the same double, integral values get a fraction so they never overflow an int
+std::string toNumberLiteral(double number)
+{
+    if (std::isnan(number))
+    {
+        return "std::numeric_limits<double>::quiet_NaN()";
+    }
+
+    if (std::isinf(number))
+    {
+        return number > 0 ? "std::numeric_limits<double>::infinity()" : "-std::numeric_limits<double>::infinity()";
+    }
+
+    char digits[32];
+    const auto [end, error] = std::to_chars(std::begin(digits), std::end(digits), number);
+    std::string literal(digits, end);
+
+    if (literal.find_first_of(".e") == std::string::npos)
+    {
+        literal += ".0";
+    }
+
+    return literal;
+}
+
+template <typename T>
+std::string toArrayLiteral(const std::vector<T>& elements)
+{
+    std::string literal = "{";
+
+    for (const auto element : elements)
+    {
+        if (literal.size() > 1)
+        {
+            literal += ", ";
+        }
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            literal += element ? "true" : "false";
+        }
+        else if constexpr (std::is_same_v<T, int>)
+        {
+            literal += std::to_string(element);
+        }
+        else
+        {
+            literal += toNumberLiteral(element);
+        }
+    }
+
+    return literal + "}";
+}
+
+// Every field is written, designated initializers leaving out members trigger -Wmissing-field-initializers
+struct EntryFields
+{
+    std::string type;
+    std::string number = "0";
+    std::string text = "{}";
+    std::string numbers = "{}";
+    std::string texts = "{}";
+};
+
+// Array elements are defined as separate arrays named after the index of the entry
+EntryFields toEntryFields(const ConfigValue& value, std::size_t index, std::string& arrays)
+{
+    const auto arrayName = "elements" + std::to_string(index);
+
+    return std::visit(
+        [&](const auto& typedValue) -> EntryFields
+        {
+            using T = std::decay_t<decltype(typedValue)>;
+
+            if constexpr (std::is_same_v<T, std::nullptr_t>)
+            {
+                return {"Null"};
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                return {"Bool", typedValue ? "true" : "false"};
+            }
+            else if constexpr (std::is_same_v<T, int>)
+            {
+                return {"Int", std::to_string(typedValue)};
+            }
+            else if constexpr (std::is_same_v<T, float>)
+            {
+                return {"Float", toNumberLiteral(typedValue)};
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                return {"Double", toNumberLiteral(typedValue)};
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                return {"String", "0", toStringLiteral(typedValue)};
+            }
+            else if constexpr (std::is_same_v<T, std::vector<std::string>>)
+            {
+                if (typedValue.empty())
+                {
+                    return {"StringArray"};
+                }
+
+                arrays += "inline constexpr std::string_view " + arrayName + "[] = {";
+
+                for (std::size_t element = 0; element < typedValue.size(); ++element)
+                {
+                    arrays += (element == 0 ? "" : ", ") + toStringLiteral(typedValue[element]);
+                }
+
+                arrays += "};\n";
+
+                return {"StringArray", "0", "{}", "{}", arrayName};
+            }
+            else
+            {
+                const auto type = std::is_same_v<T, std::vector<int>>  ? "IntArray" :
+                                  std::is_same_v<T, std::vector<bool>> ? "BoolArray" :
+                                                                         "DoubleArray";
+
+                if (typedValue.empty())
+                {
+                    return {type};
+                }
+
+                arrays += "inline constexpr double " + arrayName + "[] = " + toArrayLiteral(typedValue) + ";\n";
+
+                return {type, "0", "{}", arrayName};
+            }
+        },
+        value);
+}
+}
+
+std::string EmbeddedConfigGenerator::generate(const std::filesystem::path& configDirectory, const std::string& cxxEnv,
+                                              const std::string& name)
+{
+    if (!isIdentifier(name))
+    {
+        throw std::runtime_error("Embedded config name must be a C++ identifier: " + name);
+    }
+
+    // Sorted by key, so the generated entries can be searched by EmbeddedConfig::find()
+    std::map<std::string, ConfigValue> values;
+    // Sorted like the key index, so elements of a mapped array are applied in index order and append one by one
+    const auto compareKeys = [](const std::string& lhs, const std::string& rhs)
+    { return ConfigStore::compareKeys(lhs, rhs) < 0; };
+    std::map<std::string, std::string, decltype(compareKeys)> variables{compareKeys};
+
+    for (const auto& filePath : ConfigFileLoader::getFilePaths(configDirectory, cxxEnv))
+    {
+        std::unordered_map<std::string, ConfigValue> fileValues;
+        BorrowedStrings borrowedStrings;
+
+        ConfigFileLoader::loadConfigFile(filePath, fileValues, borrowedStrings);
+
+        const auto isEnvironmentFile = ConfigFileLoader::isEnvironmentFile(filePath);
+
+        for (auto& [key, value] : fileValues)
+        {
+            if (!isEnvironmentFile)
+            {
+                // A later file overrides the value of an earlier mapped variable or array element, as it does at runtime
+                std::erase_if(variables,
+                              [&](const auto& variable)
+                              {
+                                  return variable.first.starts_with(key) &&
+                                         (variable.first.size() == key.size() || variable.first[key.size()] == '.');
+                              });
+                values.insert_or_assign(key, std::move(value));
+                continue;
+            }
+
+            // Null values, empty objects and empty arrays map no variable
+            if (std::holds_alternative<std::nullptr_t>(value))
+            {
+                continue;
+            }
+
+            // Like loadConfigEnvFile(), an array maps one variable per element, written into the element at runtime
+            if (const auto* variableNames = std::get_if<std::vector<std::string>>(&value))
+            {
+                for (std::size_t index = 0; index < variableNames->size(); ++index)
+                {
+                    variables.insert_or_assign(key + "." + std::to_string(index), (*variableNames)[index]);
+                }
+
+                continue;
+            }
+
+            const auto* variableName = std::get_if<std::string>(&value);
+
+            if (variableName == nullptr)
+            {
+                throw std::runtime_error("Environment variable name of key '" + key + "' in " + filePath.string() +
+                                         " must be a string.");
+            }
+
+            variables.insert_or_assign(key, *variableName);
+        }
+    }
+
+    std::string arrays;
+    std::string entries;
+    std::size_t index = 0;
+
+    for (const auto& [key, value] : values)
+    {
+        const auto fields = toEntryFields(value, index++, arrays);
+
+        entries += "    {.key = " + toStringLiteral(key) + ", .type = EmbeddedType::" + fields.type +
+                   ", .number = " + fields.number + ", .text = " + fields.text + ", .numbers = " + fields.numbers +
+                   ", .texts = " + fields.texts + "},\n";
+    }
+
+    std::string header = "// Generated by config_cxx_embed() from config directory " +
+                         configDirectory.filename().string() + " for CXX_ENV=" + cxxEnv + ", do not edit.\n";
+
+    header += "#pragma once\n"
+              "\n"
+              "#include <limits>\n"
+              "#include <string_view>\n"
+              "\n"
+              "#include \"config-cxx/config.h\"\n"
+              "\n"
+              "namespace config::embedded\n"
+              "{\n"
+              "namespace " +
+              name +
+              "Data\n"
+              "{\n"
+              "using namespace std::string_view_literals;\n"
+              "\n";
+
+    if (!arrays.empty())
+    {
+        header += arrays + "\n";
+    }
+
+    if (!entries.empty())
+    {
+        header += "inline constexpr EmbeddedEntry entries[] = {\n" + entries + "};\n";
+    }
+    else
+    {
+        header += "inline constexpr std::span<const EmbeddedEntry> entries{};\n";
+    }
+
+    if (!variables.empty())
+    {
+        header += "\ninline constexpr EmbeddedVariable variables[] = {\n";
+
+        for (const auto& [key, variableName] : variables)
+        {
+            header += "    {.key = " + toStringLiteral(key) + ", .variableName = " + toStringLiteral(variableName) +
+                      "},\n";
+        }
+
+        header += "};\n";
+    }
+    else
+    {
+        header += "inline constexpr std::span<const EmbeddedVariable> variables{};\n";
+    }
+
+    header += "}\n"
+              "\n"
+              "inline constexpr EmbeddedConfig " +
+              name + "{" + name + "Data::entries, " + name +
+              "Data::variables};\n"
+              "}\n";
+
+    return header;
+}
+}
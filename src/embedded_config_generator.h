@@ -0,0 +1,21 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace config
+{
+/**
+ * Generates the C++ header embedding a config directory, run at build time by the config_cxx_embed() CMake function.
+ *
+ * The files are merged in the order Config loads them at runtime. Custom environment variable files are not resolved,
+ * the header keeps the mapped variable names so that the build environment never ends up in the binary.
+ */
+class EmbeddedConfigGenerator
+{
+public:
+    // Header defining config::embedded::<name> as an EmbeddedConfig with the merged values of the directory
+    static std::string generate(const std::filesystem::path& configDirectory, const std::string& cxxEnv,
+                                const std::string& name);
+};
+}
@@ -2,7 +2,6 @@
 
 #include <filesystem>
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
 
 #ifdef _WIN32
@@ -15,22 +14,32 @@
 #include <unistd.h>
 #endif
 
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace config::filesystem
 {
 std::string FileSystemService::read(const std::filesystem::path& absolutePath)
 {
-    std::ifstream fileStream{absolutePath};
-
-    std::stringstream buffer;
+    std::ifstream fileStream{absolutePath, std::ios::binary | std::ios::ate};
 
     if (!fileStream.is_open())
     {
         throw std::runtime_error("File not found: " + absolutePath.string());
     }
 
-    buffer << fileStream.rdbuf();
+    // Read straight into the result instead of through a stringstream, which copied the contents twice
+    std::string contents(static_cast<std::size_t>(fileStream.tellg()), '\0');
 
-    return buffer.str();
+    fileStream.seekg(0);
+    fileStream.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+    contents.resize(static_cast<std::size_t>(fileStream.gcount()));
+
+    return contents;
 }
 
 bool FileSystemService::exists(const std::filesystem::path& absolutePath)
@@ -91,4 +100,151 @@ std::filesystem::path FileSystemService::getExecutablePath()
 #endif
 }
 
+void FileSystemService::createPrivateDirectories(const std::filesystem::path& absolutePath)
+{
+#ifdef _WIN32
+    std::filesystem::create_directories(absolutePath);
+#else
+    if (absolutePath.empty() || std::filesystem::is_directory(absolutePath))
+    {
+        return;
+    }
+
+    createPrivateDirectories(absolutePath.parent_path());
+
+    if (mkdir(absolutePath.c_str(), S_IRWXU) == -1 && errno != EEXIST)
+    {
+        throw std::runtime_error("Cannot create directory: " + absolutePath.string());
+    }
+#endif
+}
+
+void FileSystemService::writePrivateFile(const std::filesystem::path& absolutePath, std::string_view contents)
+{
+#ifdef _WIN32
+    if (std::filesystem::exists(absolutePath))
+    {
+        throw std::runtime_error("File already exists: " + absolutePath.string());
+    }
+
+    std::ofstream fileStream{absolutePath, std::ios::binary};
+
+    if (!fileStream.is_open())
+    {
+        throw std::runtime_error("Cannot create file: " + absolutePath.string());
+    }
+
+    std::filesystem::permissions(absolutePath,
+                                 std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+
+    if (!fileStream.write(contents.data(), static_cast<std::streamsize>(contents.size())).flush())
+    {
+        fileStream.close();
+        std::filesystem::remove(absolutePath);
+        throw std::runtime_error("Cannot write file: " + absolutePath.string());
+    }
+#else
+    // Created with its final mode, so the contents are never readable by others whatever the umask is
+    const auto fileDescriptor = open(absolutePath.c_str(), O_CREAT | O_EXCL | O_WRONLY, S_IRUSR | S_IWUSR);
+
+    if (fileDescriptor == -1)
+    {
+        throw std::runtime_error("Cannot create file: " + absolutePath.string());
+    }
+
+    while (!contents.empty())
+    {
+        const auto written = write(fileDescriptor, contents.data(), contents.size());
+
+        if (written == -1 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (written <= 0)
+        {
+            close(fileDescriptor);
+            std::filesystem::remove(absolutePath);
+            throw std::runtime_error("Cannot write file: " + absolutePath.string());
+        }
+
+        contents.remove_prefix(static_cast<std::size_t>(written));
+    }
+
+    if (close(fileDescriptor) == -1)
+    {
+        std::filesystem::remove(absolutePath);
+        throw std::runtime_error("Cannot write file: " + absolutePath.string());
+    }
+#endif
+}
+
+MappedFile::MappedFile(const std::filesystem::path& absolutePath)
+{
+#ifdef _WIN32
+    buffer = FileSystemService::read(absolutePath);
+    contents = buffer.data();
+    contentsSize = buffer.size();
+#else
+    const auto fileDescriptor = open(absolutePath.c_str(), O_RDONLY);
+
+    if (fileDescriptor == -1)
+    {
+        throw std::runtime_error("File not found: " + absolutePath.string());
+    }
+
+    struct stat fileStatus;
+
+    if (fstat(fileDescriptor, &fileStatus) == -1)
+    {
+        close(fileDescriptor);
+        throw std::runtime_error("Cannot read file: " + absolutePath.string());
+    }
+
+    contentsSize = static_cast<std::size_t>(fileStatus.st_size);
+
+    // An empty file cannot be mapped and has no contents to parse
+    if (contentsSize != 0)
+    {
+        auto* mapping = mmap(nullptr, contentsSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+            close(fileDescriptor);
+            throw std::runtime_error("Cannot map file: " + absolutePath.string());
+        }
+
+        contents = static_cast<char*>(mapping);
+    }
+
+    // The mapping stays valid after its descriptor is closed
+    close(fileDescriptor);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (contents != nullptr)
+    {
+        munmap(contents, contentsSize);
+    }
+#endif
+}
+
+char* MappedFile::data()
+{
+    return contents;
+}
+
+std::size_t MappedFile::size() const
+{
+    return contentsSize;
+}
+
+std::string_view MappedFile::view() const
+{
+    return {contents, contentsSize};
+}
+
 }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace config::filesystem
@@ -16,5 +18,34 @@ public:
     static std::filesystem::path getSystemRootPath();
     static std::filesystem::path getCurrentWorkingDirectory();
     static std::filesystem::path getExecutablePath();
+    // Creates missing directories accessible only by the owner (0700), existing ones are left as they are
+    static void createPrivateDirectories(const std::filesystem::path& absolutePath);
+    // Creates a new file readable and writable only by the owner (0600), fails if the file exists
+    static void writePrivateFile(const std::filesystem::path& absolutePath, std::string_view contents);
+};
+
+/**
+ * Private copy-on-write mapping of a file. The contents can be modified in place by in situ parsers, changes are never
+ * written back to the file. Platforms without mmap read the file into memory instead.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& absolutePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    char* data();
+    std::size_t size() const;
+    std::string_view view() const;
+
+private:
+    char* contents = nullptr;
+    std::size_t contentsSize = 0;
+#ifdef _WIN32
+    std::string buffer;
+#endif
 };
 }
@@ -1,8 +1,13 @@
 #include "json_config_loader.h"
 
-#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include "config_provider.h"
+#include "config_value.h"
 #include "file_system_service.h"
 #include "nlohmann/json.hpp"
 
@@ -10,125 +15,340 @@ namespace config
 {
 namespace
 {
-std::string normalizeConfigKey(const std::string& str);
-ConfigValue normalizeConfigValue(const nlohmann::json& jsonObject);
-}
-
-void JsonConfigLoader::loadConfigFile(const std::filesystem::path& configFilePath,
-                                      std::unordered_map<std::string, ConfigValue>& configValues)
+/**
+ * SAX handler flattening a JSON document while it is parsed, no DOM is built.
+ *
+ * Keys are built in one reused buffer: nested keys are joined with dots and elements of arrays holding objects or
+ * arrays are visited under their index. When scalar arrays are kept, elements of an array are buffered until it ends
+ * and visited as one value, or visited one by one under their index once the array turns out to hold an object or
+ * array. Whether scalar arrays are kept or not, an empty array is visited as an empty array of strings and an empty
+ * object as null.
+ */
+template <typename LeafVisitor>
+class FlatteningSaxHandler
 {
-    const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
+public:
+    FlatteningSaxHandler(LeafVisitor& visitLeaf, bool keepScalarArrays)
+        : visitLeaf{visitLeaf}, keepScalarArrays{keepScalarArrays}
+    {
+    }
 
-    if (!configFileExists)
+    bool null()
     {
-        return;
+        return scalar(nullptr, nullptr);
     }
 
-    const auto configJson = filesystem::FileSystemService::read(configFilePath);
+    bool boolean(bool value)
+    {
+        return scalar(value, value);
+    }
 
-    nlohmann::json config;
-    try
+    bool number_integer(nlohmann::json::number_integer_t value)
     {
-        config = nlohmann::json::parse(configJson);
+        return scalar(static_cast<int>(value), static_cast<int>(value));
     }
-    catch (const std::exception& e)
+
+    bool number_unsigned(nlohmann::json::number_unsigned_t value)
     {
-        throw std::runtime_error("Failed to parse JSON file: " + configFilePath.string() + " - " + e.what());
+        return scalar(static_cast<int>(value), static_cast<int>(value));
     }
 
-    const auto flattenedConfig = config.flatten();
+    bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t&)
+    {
+        // Numbers in arrays keep double precision
+        return scalar(static_cast<float>(value), value);
+    }
 
-    for (auto it = flattenedConfig.begin(); it != flattenedConfig.end(); ++it)
+    bool string(nlohmann::json::string_t& value)
     {
-        const auto normalizedKey = normalizeConfigKey(it.key());
+        if (isBufferingArray())
+        {
+            arrayElements.emplace_back(std::move(value));
+            ++containers.back().elementCount;
+            return true;
+        }
 
-        const auto normalizedValue = normalizeConfigValue(it.value());
+        return scalar(std::move(value), nullptr);
+    }
 
-        configValues[normalizedKey] = normalizedValue;
+    bool binary(nlohmann::json::binary_t&)
+    {
+        throw std::runtime_error("Unsupported config value type.");
     }
-}
 
-void JsonConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
-                                         std::unordered_map<std::string, ConfigValue>& configValues)
-{
-    const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
+    bool start_object(std::size_t)
+    {
+        return startContainer(false);
+    }
 
-    if (!configFileExists)
+    bool key(nlohmann::json::string_t& key)
     {
-        return;
+        auto& object = containers.back();
+
+        keyPath.resize(object.keySize);
+        appendSegment(object.keySize, key);
+        ++object.elementCount;
+
+        return true;
+    }
+
+    bool end_object()
+    {
+        return endContainer();
+    }
+
+    bool start_array(std::size_t)
+    {
+        return startContainer(true);
     }
 
-    const auto configEnvironmentVariablesJson = filesystem::FileSystemService::read(configFilePath);
+    bool end_array()
+    {
+        return endContainer();
+    }
 
-    nlohmann::json configEnvironmentVariables;
-    try
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& exception)
     {
-        configEnvironmentVariables = nlohmann::json::parse(configEnvironmentVariablesJson);
+        errorMessage = exception.what();
+        return false;
     }
-    catch (const std::exception& e)
+
+    const std::string& getErrorMessage() const
     {
-        throw std::runtime_error("Failed to parse JSON env file: " + configFilePath.string() + " - " + e.what());
+        return errorMessage;
     }
 
-    const auto flattenedConfig = configEnvironmentVariables.flatten();
+private:
+    struct Container
+    {
+        bool isArray;
+        // Scalar elements of arrays are buffered until the array ends or turns out to hold an object or array
+        bool bufferingElements;
+        std::size_t keySize;
+        std::size_t elementCount;
+    };
 
-    for (auto it = flattenedConfig.begin(); it != flattenedConfig.end(); ++it)
+    bool isBufferingArray() const
     {
-        const auto normalizedKey = normalizeConfigKey(it.key());
+        return !containers.empty() && containers.back().bufferingElements;
+    }
 
-        const auto envValue = environment::ConfigProvider::parseEnvironmentVariable(it.value().get<std::string>());
+    bool scalar(ConfigValue leafValue, ConfigValue elementValue)
+    {
+        if (isBufferingArray())
+        {
+            arrayElements.push_back(std::move(elementValue));
+            ++containers.back().elementCount;
+            return true;
+        }
 
-        if (!envValue || envValue->empty())
+        if (containers.empty())
         {
-            // Environment variable not set, skip silently
-            continue;
+            // A scalar document has no key to store it under
+            return true;
         }
 
-        configValues[normalizedKey] = *envValue;
+        moveToNextElement();
+        visitLeaf(keyPath, std::move(leafValue));
+
+        return true;
     }
-}
 
-namespace
-{
-std::string normalizeConfigKey(const std::string& str)
-{
-    auto result = str.substr(1);
+    bool startContainer(bool isArray)
+    {
+        if (isBufferingArray())
+        {
+            visitBufferedElements();
+        }
 
-    std::replace(result.begin(), result.end(), '/', '.');
+        moveToNextElement();
+        containers.push_back({isArray, isArray && keepScalarArrays, keyPath.size(), 0});
 
-    return result;
-}
+        return true;
+    }
 
-ConfigValue normalizeConfigValue(const nlohmann::json& jsonObject)
-{
-    ConfigValue normalizedValue;
+    bool endContainer()
+    {
+        const auto container = containers.back();
+        containers.pop_back();
 
-    if (jsonObject.is_string())
+        keyPath.resize(container.keySize);
+
+        if (container.bufferingElements)
+        {
+            visitLeaf(keyPath, normalizeConfigArray(std::move(arrayElements)));
+            arrayElements.clear();
+        }
+        else if (container.elementCount == 0 && !keyPath.empty())
+        {
+            visitLeaf(keyPath, container.isArray ? ConfigValue{std::vector<std::string>{}} : ConfigValue{nullptr});
+        }
+
+        return true;
+    }
+
+    // Points the key buffer at the next element when the current container is an array
+    void moveToNextElement()
     {
-        normalizedValue = jsonObject.get<std::string>();
+        if (containers.empty() || !containers.back().isArray)
+        {
+            return;
+        }
+
+        auto& array = containers.back();
+
+        keyPath.resize(array.keySize);
+        appendSegment(array.keySize, std::to_string(array.elementCount++));
     }
-    else if (jsonObject.is_number_integer())
+
+    void visitBufferedElements()
     {
-        normalizedValue = jsonObject.get<int>();
+        auto& array = containers.back();
+
+        for (std::size_t index = 0; index < arrayElements.size(); ++index)
+        {
+            keyPath.resize(array.keySize);
+            appendSegment(array.keySize, std::to_string(index));
+
+            // Outside of a kept array numbers are stored as float like any other value
+            if (const auto* number = std::get_if<double>(&arrayElements[index]))
+            {
+                visitLeaf(keyPath, static_cast<float>(*number));
+            }
+            else
+            {
+                visitLeaf(keyPath, std::move(arrayElements[index]));
+            }
+        }
+
+        arrayElements.clear();
+        array.bufferingElements = false;
     }
-    else if (jsonObject.is_number_float())
+
+    void appendSegment(std::size_t parentSize, std::string_view segment)
     {
-        normalizedValue = jsonObject.get<float>();
+        if (parentSize != 0)
+        {
+            keyPath += '.';
+        }
+
+        keyPath += segment;
     }
-    else if (jsonObject.is_boolean())
+
+    static ConfigValue normalizeConfigArray(std::vector<ConfigValue> elements)
     {
-        normalizedValue = jsonObject.get<bool>();
+        if (auto typedArray = toTypedArray(elements))
+        {
+            return std::move(*typedArray);
+        }
+
+        std::vector<std::string> strings;
+        strings.reserve(elements.size());
+
+        for (const auto& element : elements)
+        {
+            strings.push_back(*cast<std::string>(element));
+        }
+
+        return strings;
     }
-    else if (jsonObject.is_null())
+
+    LeafVisitor& visitLeaf;
+    bool keepScalarArrays;
+    std::string keyPath;
+    std::vector<Container> containers;
+    std::vector<ConfigValue> arrayElements;
+    std::string errorMessage;
+};
+
+template <typename LeafVisitor>
+void parseConfig(std::string_view configJson, LeafVisitor& visitLeaf, bool keepScalarArrays,
+                 const std::string& errorPrefix)
+{
+    FlatteningSaxHandler<LeafVisitor> handler{visitLeaf, keepScalarArrays};
+
+    if (!nlohmann::json::sax_parse(configJson.begin(), configJson.end(), &handler))
     {
-        normalizedValue = nullptr;
+        throw std::runtime_error(errorPrefix + handler.getErrorMessage());
     }
-    else
+}
+
+template <typename ResolveVariable>
+void loadEnvironmentVariables(const std::filesystem::path& configFilePath,
+                              std::unordered_map<std::string, ConfigValue>& configValues,
+                              const ResolveVariable& resolveVariable)
+{
+    const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
+
+    if (!configFileExists)
     {
-        throw std::runtime_error("Unsupported config value type.");
+        return;
     }
 
-    return normalizedValue;
+    const filesystem::MappedFile configEnvironmentVariablesJson{configFilePath};
+
+    auto storeEnvironmentVariable = [&](const std::string& key, ConfigValue&& value)
+    {
+        // Empty objects and arrays map no environment variable
+        if (const auto* strings = std::get_if<std::vector<std::string>>(&value);
+            std::holds_alternative<std::nullptr_t>(value) || (strings != nullptr && strings->empty()))
+        {
+            return;
+        }
+
+        const auto* environmentVariable = std::get_if<std::string>(&value);
+
+        if (environmentVariable == nullptr)
+        {
+            throw std::runtime_error("Environment variable name of key '" + key + "' in " + configFilePath.string() +
+                                     " must be a string.");
+        }
+
+        const auto envValue = resolveVariable(*environmentVariable);
+
+        if (!envValue || envValue->empty())
+        {
+            // Environment variable not set, skip silently
+            return;
+        }
+
+        configValues[key] = *envValue;
+    };
+
+    parseConfig(configEnvironmentVariablesJson.view(), storeEnvironmentVariable, false,
+                "Failed to parse JSON env file: " + configFilePath.string() + " - ");
+}
+}
+
+void JsonConfigLoader::loadConfigFile(const std::filesystem::path& configFilePath,
+                                      std::unordered_map<std::string, ConfigValue>& configValues)
+{
+    const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
+
+    if (!configFileExists)
+    {
+        return;
+    }
+
+    // Parsed straight from the mapping, the file is never copied into a string
+    const filesystem::MappedFile configJson{configFilePath};
+
+    auto storeValue = [&](const std::string& key, ConfigValue&& value) { configValues[key] = std::move(value); };
+
+    parseConfig(configJson.view(), storeValue, true, "Failed to parse JSON file: " + configFilePath.string() + " - ");
 }
+
+void JsonConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
+                                         std::unordered_map<std::string, ConfigValue>& configValues)
+{
+    loadEnvironmentVariables(configFilePath, configValues, environment::ConfigProvider::parseEnvironmentVariable);
+}
+
+void JsonConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
+                                         std::unordered_map<std::string, ConfigValue>& configValues,
+                                         const environment::EnvironmentSnapshot& environment)
+{
+    loadEnvironmentVariables(configFilePath, configValues,
+                             [&](const std::string& envName) { return environment.getVariable(envName); });
 }
 } // namespace config
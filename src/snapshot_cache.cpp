@@ -0,0 +1,206 @@
+#include "snapshot_cache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "binary_buffer.h"
+#include "config-cxx/config.h"
+#include "config_provider.h"
+#include "config_store.h"
+#include "file_system_service.h"
+
+namespace config
+{
+namespace
+{
+constexpr std::string_view magic = "CXXCACHE";
+// Increased whenever the layout of cache files changes, a mark written in native byte order rejects caches written on
+// platforms with another one
+constexpr std::uint32_t formatVersion = 2;
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+const std::string prefixVariableName = "CXX_CONFIG_ENV_PREFIX";
+
+// Covers the mapped variables and every variable read by prefixed overrides, unset and empty variables hash differently
+std::uint64_t hashEnvironment(const std::vector<std::string>& environmentVariableNames,
+                              const environment::EnvironmentSnapshot& environment)
+{
+    std::string variables;
+
+    const auto appendVariable = [&](std::string_view envName, const std::optional<std::string_view>& envValue)
+    {
+        variables += envName;
+        variables += envValue ? '=' : '!';
+        variables += envValue.value_or("");
+        variables += '\0';
+    };
+
+    for (const auto& envName : environmentVariableNames)
+    {
+        appendVariable(envName, environment.getVariable(envName));
+    }
+
+    const auto prefix = environment.getVariable(prefixVariableName);
+    appendVariable(prefixVariableName, prefix);
+
+    if (prefix && !prefix->empty())
+    {
+        const auto variablePrefix = *prefix + "__";
+        std::vector<std::pair<std::string_view, std::string_view>> prefixedVariables;
+
+        for (const auto& [envName, envValue] : environment.getVariables())
+        {
+            if (envName.compare(0, variablePrefix.size(), variablePrefix) == 0)
+            {
+                prefixedVariables.emplace_back(envName, envValue);
+            }
+        }
+
+        std::sort(prefixedVariables.begin(), prefixedVariables.end());
+
+        for (const auto& [envName, envValue] : prefixedVariables)
+        {
+            appendVariable(envName, envValue);
+        }
+    }
+
+    return KeyPath::hashPath(variables);
+}
+
+std::string toHex(std::uint64_t value)
+{
+    char digits[16];
+    const auto [end, error] = std::to_chars(std::begin(digits), std::end(digits), value, 16);
+
+    return std::string(static_cast<std::size_t>(16 - (end - digits)), '0') + std::string(digits, end);
+}
+}
+
+SnapshotCache::SnapshotCache(const std::filesystem::path& cacheDirectory, const std::filesystem::path& configDirectory,
+                             const std::string& cxxEnv, const std::vector<std::filesystem::path>& filePaths)
+{
+    const auto directory = std::filesystem::absolute(configDirectory).lexically_normal().string();
+
+    filePath = cacheDirectory / ("config-cxx-" + toHex(KeyPath::hashPath(directory + '\0' + cxxEnv)) + ".cache");
+
+    BinaryWriter writer{source};
+    source += magic;
+    writer.write(formatVersion);
+    writer.write(byteOrderMark);
+    writer.writeString(directory);
+    writer.writeString(cxxEnv);
+    writer.write(static_cast<std::uint32_t>(filePaths.size()));
+
+    for (const auto& configFilePath : filePaths)
+    {
+        // A file that cannot be inspected is recorded as missing, which never matches a cache
+        std::error_code sizeError;
+        std::error_code timeError;
+        const auto fileSize = std::filesystem::file_size(configFilePath, sizeError);
+        const auto modificationTime = std::filesystem::last_write_time(configFilePath, timeError);
+
+        writer.writeString(configFilePath.string());
+        writer.write(static_cast<std::uint64_t>(sizeError ? UINT64_MAX : fileSize));
+        writer.write(static_cast<std::int64_t>(timeError ? INT64_MIN : modificationTime.time_since_epoch().count()));
+    }
+}
+
+std::shared_ptr<const ConfigStore> SnapshotCache::load(const environment::EnvironmentSnapshot& environment,
+                                                       std::pmr::memory_resource* memoryResource) const
+{
+    std::error_code error;
+
+    if (!std::filesystem::is_regular_file(filePath, error))
+    {
+        return nullptr;
+    }
+
+    // A cache that cannot be read is treated as missing and replaced by the next store
+    try
+    {
+        const filesystem::MappedFile cacheFile{filePath};
+        const auto contents = cacheFile.view();
+
+        if (!contents.starts_with(source))
+        {
+            return nullptr;
+        }
+
+        BinaryReader reader{contents.substr(source.size())};
+
+        std::vector<std::string> environmentVariableNames(reader.readCount(sizeof(std::uint32_t)));
+
+        for (auto& envName : environmentVariableNames)
+        {
+            envName = reader.readString();
+        }
+
+        if (reader.read<std::uint64_t>() != hashEnvironment(environmentVariableNames, environment))
+        {
+            return nullptr;
+        }
+
+        auto configStore = std::make_shared<const ConfigStore>(reader, memoryResource);
+
+        return reader.atEnd() ? configStore : nullptr;
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+void SnapshotCache::store(const ConfigStore& configStore, const std::vector<std::string>& environmentVariableNames,
+                          const environment::EnvironmentSnapshot& environment) const
+{
+    std::string contents = source;
+    BinaryWriter writer{contents};
+
+    writer.write(static_cast<std::uint32_t>(environmentVariableNames.size()));
+
+    for (const auto& envName : environmentVariableNames)
+    {
+        writer.writeString(envName);
+    }
+
+    writer.write(hashEnvironment(environmentVariableNames, environment));
+    configStore.write(writer);
+
+    // Values resolved from environment variables may be secrets, only the owner may list or read cache files
+    filesystem::FileSystemService::createPrivateDirectories(filePath.parent_path());
+
+    const auto temporaryFilePath =
+        std::filesystem::path{filePath.string() + "." + std::to_string(std::random_device{}()) + ".tmp"};
+
+    try
+    {
+        filesystem::FileSystemService::writePrivateFile(temporaryFilePath, contents);
+    }
+    catch (const std::runtime_error& error)
+    {
+        throw std::runtime_error(std::string{"Failed to write config cache: "} + error.what());
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryFilePath, filePath, error);
+
+    if (error)
+    {
+        // The temporary file holds the same secrets as the cache, it must not be left behind
+        std::filesystem::remove(temporaryFilePath, error);
+        throw std::runtime_error("Failed to write config cache: cannot rename " + temporaryFilePath.string() + " to " +
+                                 filePath.string());
+    }
+}
+
+const std::filesystem::path& SnapshotCache::getFilePath() const
+{
+    return filePath;
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace config
+{
+class ConfigStore;
+
+namespace environment
+{
+class EnvironmentSnapshot;
+}
+
+/**
+ * On-disk cache of the store loaded by Config, so the next process does not parse unchanged config files again.
+ *
+ * The cache of a config directory and CXX_ENV is a single file starting with the source it was built from: the path,
+ * size and modification time of every config file, the names of the environment variables mapped by environment
+ * files and a hash of their values and of the prefixed override variables. A cache is only used while all of them
+ * match. The image of the store written by ConfigStore::write() follows, loading copies it from the memory-mapped
+ * file into the buffers of a new store without parsing anything.
+ *
+ * Caches are written to a temporary file that is renamed over the previous cache, so processes loading concurrently
+ * never read a partially written one.
+ */
+class SnapshotCache
+{
+public:
+    SnapshotCache(const std::filesystem::path& cacheDirectory, const std::filesystem::path& configDirectory,
+                  const std::string& cxxEnv, const std::vector<std::filesystem::path>& filePaths);
+
+    // Store cached from the same files and environment, nullptr when there is no such cache or it cannot be read
+    std::shared_ptr<const ConfigStore> load(const environment::EnvironmentSnapshot& environment,
+                                            std::pmr::memory_resource* memoryResource) const;
+    void store(const ConfigStore& configStore, const std::vector<std::string>& environmentVariableNames,
+               const environment::EnvironmentSnapshot& environment) const;
+
+    const std::filesystem::path& getFilePath() const;
+
+private:
+    std::filesystem::path filePath;
+    // Header and source of the cache, a cache file is only read when it starts with exactly these bytes
+    std::string source;
+};
+}
@@ -1,9 +1,17 @@
 #include "xml_config_loader.h"
 
-#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 #include <variant>
 
 #include "config_provider.h"
+#include "config_value.h"
 #include "file_system_service.h"
 #include "pugixml.hpp"
 
@@ -11,19 +19,98 @@ namespace config
 {
 namespace
 {
-void flattenConfig(pugi::xml_node node, const std::string& parentPath,
-                   std::unordered_map<std::string, std::vector<std::string>>& flattenedConfig);
+// Leaves are borrowed from the mapped contents when borrowedStrings is set
+struct BorrowingContext
+{
+    BorrowedStrings& borrowedStrings;
+    std::string_view mappedContents;
+};
+
+void flattenConfig(pugi::xml_node node, std::string& keyPath,
+                   std::unordered_map<std::string, ConfigValue>& configValues, const BorrowingContext* borrowing);
+
+void loadXmlFile(const std::filesystem::path& configFilePath,
+                 std::unordered_map<std::string, ConfigValue>& configValues, BorrowedStrings* borrowedStrings);
+
+bool isLeaf(pugi::xml_node node);
+
+void setValue(std::unordered_map<std::string, ConfigValue>& configValues, const std::string& keyPath,
+              ConfigValue value);
+
+BaseTypes parseValue(std::string_view value);
+
+// Null, boolean or number, nothing when the value is kept as a string
+std::optional<BaseTypes> parseTypedValue(std::string_view value);
+
+template <typename ResolveVariable>
+void loadEnvironmentVariables(const std::filesystem::path& configFilePath,
+                              std::unordered_map<std::string, ConfigValue>& configValues,
+                              const ResolveVariable& resolveVariable)
+{
+    const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
 
-void parseConfig(std::unordered_map<std::string, std::vector<std::string>>& flattenedConfig,
-                 std::unordered_map<std::string, ConfigValue>& configValues);
+    if (!configFileExists)
+    {
+        return;
+    }
+
+    // Staged separately, only the keys declared by the env file are resolved and stored
+    std::unordered_map<std::string, ConfigValue> environmentVariableNames;
+    XmlConfigLoader::loadConfigFile(configFilePath, environmentVariableNames);
+
+    for (const auto& [key, value] : environmentVariableNames)
+    {
+        const auto* envName = std::get_if<std::string>(&value);
+
+        if (envName == nullptr)
+        {
+            continue;
+        }
 
-BaseTypes parseValue(const std::string& value);
+        const auto envValue = resolveVariable(*envName);
 
-std::string normalizeConfigListKey(const std::string& key);
+        if (!envValue || envValue->empty())
+        {
+            // Environment variable not set, skip silently
+            continue;
+        }
+
+        configValues[key] = *envValue;
+    }
+}
 } // anonymous namespace
 
 void XmlConfigLoader::loadConfigFile(const std::filesystem::path& configFilePath,
                                      std::unordered_map<std::string, ConfigValue>& configValues)
+{
+    loadXmlFile(configFilePath, configValues, nullptr);
+}
+
+void XmlConfigLoader::loadConfigFile(const std::filesystem::path& configFilePath,
+                                     std::unordered_map<std::string, ConfigValue>& configValues,
+                                     BorrowedStrings& borrowedStrings)
+{
+    loadXmlFile(configFilePath, configValues, &borrowedStrings);
+}
+
+void XmlConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
+                                        std::unordered_map<std::string, ConfigValue>& configValues)
+{
+    loadEnvironmentVariables(configFilePath, configValues, environment::ConfigProvider::parseEnvironmentVariable);
+}
+
+void XmlConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
+                                        std::unordered_map<std::string, ConfigValue>& configValues,
+                                        const environment::EnvironmentSnapshot& environment)
+{
+    loadEnvironmentVariables(configFilePath, configValues,
+                             [&](const std::string& envName) { return environment.getVariable(envName); });
+}
+
+namespace
+{
+void loadXmlFile(const std::filesystem::path& configFilePath,
+                 std::unordered_map<std::string, ConfigValue>& configValues, BorrowedStrings* borrowedStrings)
 {
     const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
     if (!configFileExists)
@@ -31,77 +118,240 @@ void XmlConfigLoader::loadConfigFile(const std::filesystem::path& configFilePath
         return;
     }
 
+    // Parsed in place, element names and values point into the mapping for the lifetime of the document
+    const auto configFile = std::make_shared<filesystem::MappedFile>(configFilePath);
+
+    // Comments, declarations, CDATA and attributes are never read as config values
     pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(configFilePath.c_str());
+    pugi::xml_parse_result result = doc.load_buffer_inplace(configFile->data(), configFile->size(),
+                                                            pugi::parse_minimal | pugi::parse_escapes | pugi::parse_eol);
     if (!result)
     {
         throw std::runtime_error("Failed to parse XML file: " + configFilePath.string() + " - " +
                                  std::string(result.description()));
     }
-    std::unordered_map<std::string, std::vector<std::string>> flattenedConfig;
-    flattenConfig(doc.child(configTagName.c_str()), "", flattenedConfig);
-    parseConfig(flattenedConfig, configValues);
-}
 
-void XmlConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
-                                        std::unordered_map<std::string, ConfigValue>& configValues)
-{
-    loadConfigFile(configFilePath, configValues);
-    for (auto it = configValues.begin(), end = configValues.end(); it != end; ++it)
+    std::string keyPath;
+    // Flattened on its own, so that keys defined twice in the file are told apart from keys of earlier files
+    std::unordered_map<std::string, ConfigValue> fileValues;
+    const auto borrowedCount = borrowedStrings != nullptr ? borrowedStrings->values.size() : 0;
+
+    if (borrowedStrings == nullptr)
     {
-        if (std::holds_alternative<std::string>(it->second))
-        {
-            std::string envKey = std::get<std::string>(it->second);
-            const auto envValue = environment::ConfigProvider::parseEnvironmentVariable(envKey);
+        flattenConfig(doc.child(configTagName.c_str()), keyPath, fileValues, nullptr);
+    }
+    else
+    {
+        const BorrowingContext borrowing{*borrowedStrings, configFile->view()};
 
-            if (!envValue || envValue->empty())
-            {
-                // Environment variable not set, skip silently
-                continue;
-            }
-            configValues[it->first] = *envValue;
+        flattenConfig(doc.child(configTagName.c_str()), keyPath, fileValues, &borrowing);
+
+        // The mapping outlives the document only when some value still points into it
+        if (borrowedStrings->values.size() != borrowedCount)
+        {
+            borrowedStrings->owners.push_back(configFile);
         }
     }
+
+    if (configValues.empty())
+    {
+        configValues = std::move(fileValues);
+        return;
+    }
+
+    for (auto& [key, value] : fileValues)
+    {
+        configValues.insert_or_assign(key, std::move(value));
+    }
 }
 
-namespace
+// Text of a leaf inside the mapping, unescaping in place never moves it outside. Encodings pugixml converts are parsed
+// from a buffer owned by the document, their values are never borrowed
+std::optional<std::string_view> findBorrowableText(std::string_view text, const BorrowingContext& borrowing)
 {
-void flattenConfig(pugi::xml_node node, const std::string& parentPath,
-                   std::unordered_map<std::string, std::vector<std::string>>& flattenedConfig)
+    const auto& mapped = borrowing.mappedContents;
+
+    if (text.size() < borrowing.borrowedStrings.minSize || text.data() < mapped.data() ||
+        text.data() + text.size() > mapped.data() + mapped.size())
+    {
+        return std::nullopt;
+    }
+
+    return text;
+}
+
+void flattenConfig(pugi::xml_node node, std::string& keyPath,
+                   std::unordered_map<std::string, ConfigValue>& configValues, const BorrowingContext* borrowing)
 {
+    const auto parentSize = keyPath.size();
+
+    const auto appendSegment = [&](std::string_view segment)
+    {
+        if (parentSize != 0)
+        {
+            keyPath += '.';
+        }
+
+        keyPath += segment;
+    };
+
+    // Elements with the same name become adjacent while keeping their document order
+    const auto groupByName = [](std::vector<pugi::xml_node>& nodes)
+    {
+        std::stable_sort(nodes.begin(), nodes.end(), [](pugi::xml_node lhs, pugi::xml_node rhs)
+                         { return std::strcmp(lhs.name(), rhs.name()) < 0; });
+    };
+
+    const auto findGroupEnd = [](std::vector<pugi::xml_node>::iterator first,
+                                 std::vector<pugi::xml_node>::iterator end)
+    {
+        return std::find_if(first, end,
+                            [&](pugi::xml_node node) { return std::strcmp(node.name(), first->name()) != 0; });
+    };
+
+    std::vector<pugi::xml_node> leaves;
+    std::vector<pugi::xml_node> objects;
+
     for (pugi::xml_node child : node.children())
     {
-        std::string path = parentPath.empty() ? child.name() : parentPath + "." + child.name();
+        (isLeaf(child) ? leaves : objects).push_back(child);
+    }
 
-        if (child.first_child() && (child.first_child().type() == pugi::node_pcdata || child.first_child().empty()))
+    const auto childCount = leaves.size() + objects.size();
+
+    // A list wrapped in its own parent, <servers><server/><server/></servers>, is stored under the parent. Lists next
+    // to other elements keep their element name, so that two lists of one parent never share their keys.
+    const auto appendListSegment = [&](std::vector<pugi::xml_node>::iterator first,
+                                       std::vector<pugi::xml_node>::iterator last)
+    {
+        if (static_cast<std::size_t>(last - first) != childCount)
         {
-            flattenedConfig[path].push_back(child.first_child().value());
+            appendSegment(first->name());
+        }
+    };
+
+    groupByName(objects);
+
+    for (auto first = objects.begin(); first != objects.end();)
+    {
+        const auto last = findGroupEnd(first, objects.end());
+
+        if (last - first > 1)
+        {
+            // Repeated elements with children form a list of objects stored by index
+            appendListSegment(first, last);
+            const auto listSize = keyPath.size();
+
+            for (auto object = first; object != last; ++object)
+            {
+                if (listSize != 0)
+                {
+                    keyPath += '.';
+                }
+
+                keyPath += std::to_string(object - first);
+                flattenConfig(*object, keyPath, configValues, borrowing);
+                keyPath.resize(listSize);
+            }
         }
         else
         {
-            flattenConfig(child, path, flattenedConfig);
+            appendSegment(first->name());
+            flattenConfig(*first, keyPath, configValues, borrowing);
         }
+
+        keyPath.resize(parentSize);
+        first = last;
     }
-}
 
-void parseConfig(std::unordered_map<std::string, std::vector<std::string>>& flattenedConfig,
-                 std::unordered_map<std::string, ConfigValue>& ConfigValue)
-{
-    for (auto& [key, values] : flattenedConfig)
+    groupByName(leaves);
+
+    for (auto first = leaves.begin(); first != leaves.end();)
     {
-        if (values.size() > 1)
+        const auto last = findGroupEnd(first, leaves.end());
+
+        if (last - first > 1)
         {
-            ConfigValue[normalizeConfigListKey(key)] = std::move(values);
+            // Repeated leaf elements form a list
+            appendListSegment(first, last);
+
+            std::vector<ConfigValue> elements;
+            elements.reserve(static_cast<std::size_t>(last - first));
+
+            for (auto leaf = first; leaf != last; ++leaf)
+            {
+                std::visit([&](auto&& arg) { elements.emplace_back(arg); }, parseValue(leaf->first_child().value()));
+            }
+
+            if (auto typedArray = toTypedArray(elements))
+            {
+                setValue(configValues, keyPath, std::move(*typedArray));
+            }
+            else
+            {
+                std::vector<std::string> values;
+                values.reserve(elements.size());
+
+                for (auto leaf = first; leaf != last; ++leaf)
+                {
+                    values.emplace_back(leaf->first_child().value());
+                }
+
+                setValue(configValues, keyPath, std::move(values));
+            }
+
+            keyPath.resize(parentSize);
         }
-        else if (values.size() == 1)
+        else
         {
-            BaseTypes parsedValue = parseValue(values[0]);
-            std::visit([&](auto&& arg) { ConfigValue[key] = arg; }, parsedValue);
+            appendSegment(first->name());
+
+            const std::string_view value = first->first_child().value();
+            auto parsedValue = parseTypedValue(value);
+            const auto borrowedText =
+                !parsedValue && borrowing != nullptr ? findBorrowableText(value, *borrowing) : std::nullopt;
+
+            if (borrowedText)
+            {
+                // Placeholder for the store, which reads the value from the mapping
+                borrowing->borrowedStrings.values.insert_or_assign(keyPath, *borrowedText);
+                setValue(configValues, keyPath, std::string{});
+            }
+            else
+            {
+                std::visit([&](auto&& arg) { setValue(configValues, keyPath, std::move(arg)); },
+                           parsedValue ? std::move(*parsedValue) : BaseTypes{std::string{value}});
+            }
+
+            keyPath.resize(parentSize);
         }
+
+        first = last;
     }
 }
 
-BaseTypes parseValue(const std::string& value)
+bool isLeaf(pugi::xml_node node)
+{
+    return node.first_child() && (node.first_child().type() == pugi::node_pcdata || node.first_child().empty());
+}
+
+void setValue(std::unordered_map<std::string, ConfigValue>& configValues, const std::string& keyPath,
+              ConfigValue value)
+{
+    if (!configValues.try_emplace(keyPath, std::move(value)).second)
+    {
+        throw std::runtime_error("XML config key '" + keyPath + "' is defined more than once.");
+    }
+}
+
+BaseTypes parseValue(std::string_view value)
+{
+    auto parsedValue = parseTypedValue(value);
+
+    return parsedValue ? std::move(*parsedValue) : BaseTypes{std::string{value}};
+}
+
+std::optional<BaseTypes> parseTypedValue(std::string_view value)
 {
     if (value.empty())
     {
@@ -111,41 +361,43 @@ BaseTypes parseValue(const std::string& value)
     {
         return "true" == value;
     }
-    try
+
+    // Leading whitespace and a plus sign are accepted like with std::stof and std::stoi
+    auto number = value;
+
+    while (!number.empty() && std::isspace(static_cast<unsigned char>(number.front())))
+    {
+        number.remove_prefix(1);
+    }
+
+    if (number.size() > 1 && number[0] == '+' && number[1] != '-' && number[1] != '+')
     {
-        size_t pos = 0;
-        if (value.find('.') != std::string::npos)
-        {
-            float f_val = std::stof(value, &pos);
-            if (pos == value.size())
-            {
-                return f_val;
-            }
-            double d_val = std::stod(value, &pos);
-            if (pos == value.size())
-            {
-                return d_val;
-            }
-        }
-        int i_val = std::stoi(value, &pos);
-        if (pos == value.size())
+        number.remove_prefix(1);
+    }
+
+    const auto* const begin = number.data();
+    const auto* const end = number.data() + number.size();
+
+    if (number.find('.') != std::string_view::npos)
+    {
+        float floatValue;
+        const auto [floatEnd, floatError] = std::from_chars(begin, end, floatValue);
+
+        if (floatError == std::errc{} && floatEnd == end)
         {
-            return i_val;
+            return floatValue;
         }
     }
-    catch (...)
+
+    int intValue;
+    const auto [intEnd, intError] = std::from_chars(begin, end, intValue);
+
+    if (intError == std::errc{} && intEnd == end)
     {
+        return intValue;
     }
-    return value;
-}
-
-std::string normalizeConfigListKey(const std::string& key)
-{
-    size_t last_dot = key.rfind('.');
-    if (last_dot == std::string::npos)
-        return key;
 
-    return key.substr(0, last_dot);
+    return std::nullopt;
 }
 } // anonymous namespace
 } // config namespace
@@ -6,18 +6,34 @@
 #include <variant>
 #include <vector>
 
+#include "config-cxx/config.h"
+
 namespace config
 {
+namespace environment
+{
+class EnvironmentSnapshot;
+}
+
+struct BorrowedStrings;
+
 const std::string configTagName = "configuration";
 using BaseTypes = std::variant<std::nullptr_t, bool, int, float, double, std::string>;
-using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>>;
 
 class XmlConfigLoader
 {
 public:
     static void loadConfigFile(const std::filesystem::path& configFilePath,
                                std::unordered_map<std::string, ConfigValue>& configValues);
+    // Single values of at least borrowedStrings.minSize bytes are left in the mapped file instead of being copied
+    static void loadConfigFile(const std::filesystem::path& configFilePath,
+                               std::unordered_map<std::string, ConfigValue>& configValues,
+                               BorrowedStrings& borrowedStrings);
     static void loadConfigEnvFile(const std::filesystem::path& configFilePath,
                                   std::unordered_map<std::string, ConfigValue>& configValues);
+    // Resolves the mapped variables from a snapshot of the environment instead of calling getenv for each of them
+    static void loadConfigEnvFile(const std::filesystem::path& configFilePath,
+                                  std::unordered_map<std::string, ConfigValue>& configValues,
+                                  const environment::EnvironmentSnapshot& environment);
 };
 } // config namespace
\ No newline at end of file
@@ -1,19 +1,67 @@
 #include "yaml_config_loader.h"
 
-#include <functional>
-#include <iostream>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
 #include <variant>
 
 #include "config_provider.h"
+#include "config_value.h"
 #include "file_system_service.h"
+#include "yaml-cpp/eventhandler.h"
 #include "yaml-cpp/yaml.h"
 
 namespace config
 {
 namespace
 {
-ConfigValue getScalarValue(YAML::Node node);
-void flattenConfig(YAML::Node& configNode, std::unordered_map<std::string, ConfigValue>& configValues);
+void flattenConfig(const std::filesystem::path& configFilePath,
+                   std::unordered_map<std::string, ConfigValue>& configValues);
+ConfigValue getScalarValue(std::string_view scalar);
+
+template <typename ResolveVariable>
+void loadEnvironmentVariables(const std::filesystem::path& configFilePath,
+                              std::unordered_map<std::string, ConfigValue>& configValues,
+                              const ResolveVariable& resolveVariable)
+{
+    const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
+
+    if (!configFileExists)
+    {
+        return;
+    }
+
+    // Staged separately, only the keys declared by the env file are resolved and stored
+    std::unordered_map<std::string, ConfigValue> environmentVariableNames;
+    flattenConfig(configFilePath, environmentVariableNames);
+
+    for (const auto& [key, value] : environmentVariableNames)
+    {
+        const auto* envName = std::get_if<std::string>(&value);
+
+        if (envName == nullptr)
+        {
+            continue;
+        }
+
+        const auto envValue = resolveVariable(*envName);
+
+        if (!envValue || envValue->empty())
+        {
+            // Environment variable not set, skip silently
+            continue;
+        }
+
+        configValues[key] = *envValue;
+    }
+}
 }
 
 void YamlConfigLoader::loadConfigFile(const std::filesystem::path& configFilePath,
@@ -26,127 +74,468 @@ void YamlConfigLoader::loadConfigFile(const std::filesystem::path& configFilePat
         return;
     }
 
-    YAML::Node configNode = YAML::LoadFile(configFilePath.string());
-    flattenConfig(configNode, configValues);
+    flattenConfig(configFilePath, configValues);
 }
 
 void YamlConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
                                          std::unordered_map<std::string, ConfigValue>& configValues)
 {
-    const auto configFileExists = filesystem::FileSystemService::exists(configFilePath);
+    loadEnvironmentVariables(configFilePath, configValues, environment::ConfigProvider::parseEnvironmentVariable);
+}
 
-    if (!configFileExists)
+void YamlConfigLoader::loadConfigEnvFile(const std::filesystem::path& configFilePath,
+                                         std::unordered_map<std::string, ConfigValue>& configValues,
+                                         const environment::EnvironmentSnapshot& environment)
+{
+    loadEnvironmentVariables(configFilePath, configValues,
+                             [&](const std::string& envName) { return environment.getVariable(envName); });
+}
+
+namespace
+{
+/**
+ * Flattens the parser events of a YAML document into config values, no node tree is built.
+ *
+ * Map keys are joined with dots in one reused key buffer. Scalars of a sequence are buffered until the sequence ends
+ * and stored as one array, or stored one by one under their index once the sequence turns out to hold a map, a
+ * sequence or a null. Null values are skipped. Anchored nodes are recorded so aliases can replay them.
+ */
+class FlatteningEventHandler : public YAML::EventHandler
+{
+public:
+    explicit FlatteningEventHandler(std::unordered_map<std::string, ConfigValue>& configValues)
+        : configValues{configValues}
     {
-        return;
     }
 
-    YAML::Node configNode = YAML::LoadFile(configFilePath.string());
-    flattenConfig(configNode, configValues);
+    void OnDocumentStart(const YAML::Mark&) override {}
+
+    void OnDocumentEnd() override {}
+
+    void OnNull(const YAML::Mark&, YAML::anchor_t anchor) override
+    {
+        handleEvent({Event::Type::Null, {}}, anchor);
+    }
 
-    for (auto it = configValues.begin(); it != configValues.end(); ++it)
+    void OnAlias(const YAML::Mark&, YAML::anchor_t anchor) override
     {
-        if (std::holds_alternative<std::string>(it->second))
+        const auto anchoredEvents = anchors.find(anchor);
+
+        if (anchoredEvents == anchors.end())
         {
-            std::string envKey = std::get<std::string>(it->second);
-            const auto envValue = environment::ConfigProvider::parseEnvironmentVariable(envKey);
+            return;
+        }
 
-            if (!envValue || envValue->empty())
-            {
-                // Environment variable not set, skip silently
-                continue;
-            }
-            configValues[it->first] = *envValue;
+        // Copied as replaying may record into anchors that are still open
+        const auto events = anchoredEvents->second;
+
+        for (const auto& event : events)
+        {
+            handleEvent(event, YAML::NullAnchor);
         }
     }
-}
 
-namespace
-{
-void flattenConfig(YAML::Node& configNode, std::unordered_map<std::string, ConfigValue>& configValues)
-{
-    std::function<void(const YAML::Node&, std::string, std::unordered_map<std::string, ConfigValue>&)>
-        flattenRecursive =
-            [&](const YAML::Node& node, std::string prefix, std::unordered_map<std::string, ConfigValue>& configValues)
+    void OnScalar(const YAML::Mark&, const std::string&, YAML::anchor_t anchor, const std::string& value) override
+    {
+        handleEvent({Event::Type::Scalar, value}, anchor);
+    }
+
+    void OnSequenceStart(const YAML::Mark&, const std::string&, YAML::anchor_t anchor,
+                         YAML::EmitterStyle::value) override
+    {
+        handleEvent({Event::Type::SequenceStart, {}}, anchor);
+    }
+
+    void OnSequenceEnd() override
+    {
+        handleEvent({Event::Type::SequenceEnd, {}}, YAML::NullAnchor);
+    }
+
+    void OnMapStart(const YAML::Mark&, const std::string&, YAML::anchor_t anchor, YAML::EmitterStyle::value) override
     {
-        if (node.IsScalar())
+        handleEvent({Event::Type::MapStart, {}}, anchor);
+    }
+
+    void OnMapEnd() override
+    {
+        handleEvent({Event::Type::MapEnd, {}}, YAML::NullAnchor);
+    }
+
+private:
+    struct Event
+    {
+        enum class Type
+        {
+            Null,
+            Scalar,
+            SequenceStart,
+            SequenceEnd,
+            MapStart,
+            MapEnd
+        };
+
+        Type type;
+        std::string scalar;
+    };
+
+    struct Node
+    {
+        bool isSequence;
+        // Scalars of a sequence are buffered until it ends or turns out to hold a map, a sequence or a null
+        bool bufferingScalars;
+        bool expectingKey;
+        std::size_t keySize;
+        std::size_t elementCount;
+    };
+
+    struct Recording
+    {
+        YAML::anchor_t anchor;
+        std::size_t depth;
+    };
+
+    void handleEvent(const Event& event, YAML::anchor_t anchor)
+    {
+        const auto isStart = event.type == Event::Type::SequenceStart || event.type == Event::Type::MapStart;
+        const auto isEnd = event.type == Event::Type::SequenceEnd || event.type == Event::Type::MapEnd;
+
+        if (anchor != YAML::NullAnchor)
         {
-            configValues[prefix] = getScalarValue(node);
+            anchors[anchor].clear();
+            recordings.push_back({anchor, nodes.size()});
         }
-        else if (node.IsMap())
+
+        for (const auto& recording : recordings)
         {
-            for (const auto& pair : node)
-            {
-                std::string prefixKey =
-                    prefix.length() == 0 ? pair.first.as<std::string>() : prefix + "." + pair.first.as<std::string>();
-                flattenRecursive(pair.second, prefixKey, configValues);
-            }
+            anchors[recording.anchor].push_back(event);
         }
-        else if (node.IsSequence())
+
+        switch (event.type)
         {
-            std::vector<std::string> seq;
-            if (node.size() == 0)
-            {
-                // Empty sequence
-                configValues[prefix] = seq;
-            }
-            else if (node[0].IsScalar())
+        case Event::Type::Null:
+            onValue(nullptr);
+            break;
+        case Event::Type::Scalar:
+            onValue(&event.scalar);
+            break;
+        case Event::Type::SequenceStart:
+        case Event::Type::MapStart:
+            startNode(event.type == Event::Type::SequenceStart);
+            break;
+        case Event::Type::SequenceEnd:
+        case Event::Type::MapEnd:
+            endNode();
+            break;
+        }
+
+        // A recording ends with the scalar or the end of the container it started with
+        if (!recordings.empty() && recordings.back().depth == nodes.size() &&
+            (isEnd || (!isStart && anchor != YAML::NullAnchor)))
+        {
+            recordings.pop_back();
+        }
+    }
+
+    // Handles a scalar, or a null when scalar is nullptr
+    void onValue(const std::string* scalar)
+    {
+        if (!nodes.empty() && nodes.back().expectingKey)
+        {
+            auto& map = nodes.back();
+
+            keyPath.resize(map.keySize);
+            appendSegment(map.keySize, scalar != nullptr ? *scalar : std::string_view{});
+            map.expectingKey = false;
+
+            return;
+        }
+
+        if (!nodes.empty() && nodes.back().bufferingScalars)
+        {
+            if (scalar != nullptr)
             {
-                for (size_t i = 0; i < node.size(); ++i)
-                {
-                    seq.push_back(node[i].as<std::string>());
-                }
-                configValues[prefix] = seq;
+                sequenceScalars.push_back(*scalar);
+                ++nodes.back().elementCount;
+                return;
             }
-            else
+
+            storeBufferedScalars();
+        }
+
+        moveToValue();
+
+        if (scalar != nullptr)
+        {
+            configValues[keyPath] = getScalarValue(*scalar);
+        }
+    }
+
+    void startNode(bool isSequence)
+    {
+        if (!nodes.empty() && nodes.back().expectingKey)
+        {
+            throw std::runtime_error("YAML map keys must be scalars.");
+        }
+
+        if (!nodes.empty() && nodes.back().bufferingScalars)
+        {
+            storeBufferedScalars();
+        }
+
+        moveToValue();
+
+        nodes.push_back({isSequence, isSequence, !isSequence, keyPath.size(), 0});
+    }
+
+    void endNode()
+    {
+        const auto node = nodes.back();
+        nodes.pop_back();
+
+        keyPath.resize(node.keySize);
+
+        if (node.bufferingScalars)
+        {
+            storeSequence();
+        }
+    }
+
+    // Points the key buffer at the value: the next index in a sequence, the already appended key in a map
+    void moveToValue()
+    {
+        if (nodes.empty())
+        {
+            return;
+        }
+
+        auto& parent = nodes.back();
+
+        if (parent.isSequence)
+        {
+            keyPath.resize(parent.keySize);
+            appendSegment(parent.keySize, std::to_string(parent.elementCount++));
+        }
+        else
+        {
+            parent.expectingKey = true;
+        }
+    }
+
+    void storeBufferedScalars()
+    {
+        auto& sequence = nodes.back();
+
+        for (std::size_t index = 0; index < sequenceScalars.size(); ++index)
+        {
+            keyPath.resize(sequence.keySize);
+            appendSegment(sequence.keySize, std::to_string(index));
+
+            configValues[keyPath] = getScalarValue(sequenceScalars[index]);
+        }
+
+        sequenceScalars.clear();
+        sequence.bufferingScalars = false;
+    }
+
+    void storeSequence()
+    {
+        std::vector<ConfigValue> elements;
+        elements.reserve(sequenceScalars.size());
+
+        for (const auto& scalar : sequenceScalars)
+        {
+            elements.push_back(getScalarValue(scalar));
+        }
+
+        if (auto typedArray = toTypedArray(elements))
+        {
+            configValues[keyPath] = std::move(*typedArray);
+        }
+        else
+        {
+            configValues[keyPath] = std::move(sequenceScalars);
+        }
+
+        sequenceScalars.clear();
+    }
+
+    void appendSegment(std::size_t parentSize, std::string_view segment)
+    {
+        if (parentSize != 0)
+        {
+            keyPath += '.';
+        }
+
+        keyPath += segment;
+    }
+
+    std::unordered_map<std::string, ConfigValue>& configValues;
+    std::string keyPath;
+    std::vector<Node> nodes;
+    std::vector<std::string> sequenceScalars;
+    std::map<YAML::anchor_t, std::vector<Event>> anchors;
+    std::vector<Recording> recordings;
+};
+
+void flattenConfig(const std::filesystem::path& configFilePath,
+                   std::unordered_map<std::string, ConfigValue>& configValues)
+{
+    std::ifstream configFile{configFilePath};
+
+    if (!configFile)
+    {
+        throw YAML::BadFile(configFilePath.string());
+    }
+
+    YAML::Parser parser{configFile};
+    FlatteningEventHandler handler{configValues};
+
+    // Like YAML::LoadFile only the first document is loaded
+    parser.HandleNextDocument(handler);
+}
+
+bool equalsFlexibleCase(std::string_view scalar, std::string_view lowercase)
+{
+    if (scalar.size() != lowercase.size())
+    {
+        return false;
+    }
+
+    // Accepts "true", "TRUE" and "True" but not "tRUE"
+    const auto matches = [&](std::size_t begin, bool upper)
+    {
+        for (auto index = begin; index < scalar.size(); ++index)
+        {
+            const auto expected = upper ? static_cast<char>(lowercase[index] - 'a' + 'A') : lowercase[index];
+
+            if (scalar[index] != expected)
             {
-                throw std::runtime_error("Unsupported Config: List of non-scalar datatype");
+                return false;
             }
         }
+
+        return true;
     };
 
-    flattenRecursive(configNode, "", configValues);
+    const auto firstMatches = scalar[0] == lowercase[0] || scalar[0] == lowercase[0] - 'a' + 'A';
+
+    return firstMatches && (matches(1, false) || matches(0, true));
 }
 
-ConfigValue getScalarValue(YAML::Node node)
+std::optional<bool> parseBool(std::string_view scalar)
 {
-    bool set = false;
-    ConfigValue nodeValue;
-    try
+    for (const auto name : {"y", "yes", "true", "on"})
     {
-        double num = node.as<double>();
-        if (num != static_cast<double>(static_cast<int>(num)))
+        if (equalsFlexibleCase(scalar, name))
         {
-            nodeValue = num;
+            return true;
         }
-        else
+    }
+
+    for (const auto name : {"n", "no", "false", "off"})
+    {
+        if (equalsFlexibleCase(scalar, name))
         {
-            nodeValue = node.as<int>();
+            return false;
         }
-        set = true;
     }
-    catch (const YAML::BadConversion& e)
+
+    return std::nullopt;
+}
+
+std::optional<double> parseDouble(std::string_view scalar)
+{
+    if (scalar == ".inf" || scalar == ".Inf" || scalar == ".INF" || scalar == "+.inf" || scalar == "+.Inf" ||
+        scalar == "+.INF")
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    if (scalar == "-.inf" || scalar == "-.Inf" || scalar == "-.INF")
+    {
+        return -std::numeric_limits<double>::infinity();
+    }
+
+    if (scalar == ".nan" || scalar == ".NaN" || scalar == ".NAN")
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Only plain decimal notation, from_chars alone would also accept "inf" and "nan"
+    const auto digits = scalar.substr(!scalar.empty() && scalar[0] == '-' ? 1 : 0);
+
+    if (digits.empty() || !(std::isdigit(static_cast<unsigned char>(digits[0])) || digits[0] == '.'))
+    {
+        return std::nullopt;
+    }
+
+    double number;
+    const auto [end, error] = std::from_chars(scalar.data(), scalar.data() + scalar.size(), number);
+
+    if (error != std::errc{} || end != scalar.data() + scalar.size())
     {
+        return std::nullopt;
     }
 
-    if (!set)
+    return number;
+}
+
+std::optional<int> parseInt(std::string_view scalar)
+{
+    const auto digits = scalar.substr(!scalar.empty() && scalar[0] == '-' ? 1 : 0);
+
+    // A leading zero selects octal, as with yaml-cpp's stream based conversion
+    const auto base = digits.size() > 1 && digits[0] == '0' ? 8 : 10;
+
+    int number;
+    const auto [end, error] = std::from_chars(scalar.data(), scalar.data() + scalar.size(), number, base);
+
+    if (error != std::errc{} || end != scalar.data() + scalar.size())
     {
-        try
+        return std::nullopt;
+    }
+
+    return number;
+}
+
+// Classifies a scalar without yaml-cpp conversions, which throw on every mismatch
+ConfigValue getScalarValue(std::string_view scalar)
+{
+    auto number = scalar;
+
+    while (!number.empty() && std::isspace(static_cast<unsigned char>(number.back())))
+    {
+        number.remove_suffix(1);
+    }
+
+    if (number.size() > 1 && number[0] == '+' &&
+        (std::isdigit(static_cast<unsigned char>(number[1])) || number[1] == '.'))
+    {
+        number.remove_prefix(1);
+    }
+
+    if (const auto decimal = parseDouble(number))
+    {
+        const auto isWhole = std::trunc(*decimal) == *decimal;
+        const auto fitsInt = *decimal >= std::numeric_limits<int>::min() && *decimal <= std::numeric_limits<int>::max();
+
+        if (!isWhole || !fitsInt)
         {
-            nodeValue = node.as<bool>();
-            set = true;
+            return *decimal;
         }
-        catch (const YAML::BadConversion& e)
+
+        // Whole numbers written as "1.0" or "1e3" are not read as int and stay strings
+        if (const auto integer = parseInt(number))
         {
+            return *integer;
         }
     }
-
-    if (!set)
+    else if (const auto boolean = parseBool(scalar))
     {
-        nodeValue = node.as<std::string>();
+        return *boolean;
     }
 
-    return nodeValue;
+    return std::string{scalar};
 }
-
 }
 }
@@ -6,9 +6,15 @@
 #include <variant>
 #include <vector>
 
+#include "config-cxx/config.h"
+
 namespace config
 {
-using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>>;
+namespace environment
+{
+class EnvironmentSnapshot;
+}
+
 class YamlConfigLoader
 {
 public:
@@ -16,5 +22,9 @@ public:
                                std::unordered_map<std::string, ConfigValue>& configValues);
     static void loadConfigEnvFile(const std::filesystem::path& configFilePath,
                                   std::unordered_map<std::string, ConfigValue>& configValues);
+    // Resolves the mapped variables from a snapshot of the environment instead of calling getenv for each of them
+    static void loadConfigEnvFile(const std::filesystem::path& configFilePath,
+                                  std::unordered_map<std::string, ConfigValue>& configValues,
+                                  const environment::EnvironmentSnapshot& environment);
 };
 };
@@ -0,0 +1,87 @@
+#include "compact_value.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+using namespace config;
+
+TEST(CompactValueTest, defaultValue_isNull)
+{
+    const CompactValue value;
+
+    ASSERT_TRUE(value.isNull());
+    ASSERT_EQ(value.toConfigValue(), ConfigValue{nullptr});
+}
+
+TEST(CompactValueTest, toConfigValue_givenScalars_returnsSameAlternative)
+{
+    ASSERT_EQ(CompactValue::fromBool(true).toConfigValue(), ConfigValue{true});
+    ASSERT_EQ(CompactValue::fromInt(3306).toConfigValue(), ConfigValue{3306});
+    ASSERT_EQ(CompactValue::fromDouble(1.5).toConfigValue(), ConfigValue{1.5});
+    ASSERT_EQ(CompactValue::fromFloat(2.5f).toConfigValue(), ConfigValue{2.5f});
+}
+
+TEST(CompactValueTest, toConfigValue_givenStringAndStringArray_copiesReferencedCharacters)
+{
+    const std::string host = "localhost";
+    const std::vector<std::string_view> roles = {"admin", "user"};
+
+    const auto hostValue = CompactValue::fromString(host);
+    const auto rolesValue = CompactValue::fromStringArray(roles);
+
+    ASSERT_EQ(hostValue.getType(), CompactValue::Type::String);
+    ASSERT_EQ(hostValue.asString().data(), host.data());
+    ASSERT_EQ(hostValue.toConfigValue(), ConfigValue{host});
+    ASSERT_EQ(rolesValue.getType(), CompactValue::Type::StringArray);
+    ASSERT_EQ(rolesValue.toConfigValue(), (ConfigValue{std::vector<std::string>{"admin", "user"}}));
+}
+
+TEST(CompactValueTest, cast_followsConfigValueConversionRules)
+{
+    const std::string host = "localhost";
+
+    ASSERT_EQ(cast<int>(CompactValue::fromInt(3306)), 3306);
+    ASSERT_EQ(cast<int>(CompactValue::fromDouble(3.7)), cast<int>(ConfigValue{3.7}));
+    ASSERT_EQ(cast<float>(CompactValue::fromInt(2)), 2.0f);
+    ASSERT_EQ(cast<bool>(CompactValue::fromBool(true)), true);
+    ASSERT_EQ(cast<std::string>(CompactValue::fromString(host)), host);
+    ASSERT_EQ(cast<std::string>(CompactValue::fromInt(3306)), cast<std::string>(ConfigValue{3306}));
+    ASSERT_EQ(cast<std::string>(CompactValue::fromFloat(1.5f)), cast<std::string>(ConfigValue{1.5f}));
+    ASSERT_FALSE(cast<int>(CompactValue::fromString(host)).has_value());
+    ASSERT_FALSE(cast<int>(CompactValue{}).has_value());
+}
+
+TEST(CompactValueTest, getElement_givenTypedArrays_returnsElementInNativeType)
+{
+    const std::vector<int> ports = {8080, 8081};
+    const std::vector<double> weights = {0.5};
+    const bool flags[] = {false, true};
+
+    const auto portsValue = CompactValue::fromIntArray(ports);
+
+    ASSERT_TRUE(portsValue.isArray());
+    ASSERT_EQ(portsValue.asIntArray().data(), ports.data());
+    ASSERT_EQ(portsValue.getElement(1)->asInt(), 8081);
+    ASSERT_FALSE(portsValue.getElement(2).has_value());
+    ASSERT_EQ(CompactValue::fromDoubleArray(weights).getElement(0)->asDouble(), 0.5);
+    ASSERT_TRUE(CompactValue::fromBoolArray(flags).getElement(1)->asBool());
+    ASSERT_FALSE(CompactValue::fromInt(1).getElement(0).has_value());
+    ASSERT_EQ(portsValue.toConfigValue(), ConfigValue{ports});
+}
+
+TEST(CompactValueTest, cast_givenTypedArray_convertsElementsOrViewsStoredElements)
+{
+    const std::vector<int> ports = {8080, 8081};
+    const auto portsValue = CompactValue::fromIntArray(ports);
+
+    ASSERT_EQ(cast<std::vector<double>>(portsValue), (std::vector<double>{8080.0, 8081.0}));
+    ASSERT_EQ(cast<std::vector<std::string>>(portsValue), (std::vector<std::string>{"8080", "8081"}));
+    ASSERT_EQ(cast<std::span<const int>>(portsValue)->data(), ports.data());
+    ASSERT_FALSE(cast<std::span<const double>>(portsValue).has_value());
+    ASSERT_FALSE(cast<int>(portsValue).has_value());
+}
@@ -0,0 +1,135 @@
+#include "config-cxx/config.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+#include "environment_setter.h"
+#include "file_system_service.h"
+
+using namespace ::testing;
+using namespace config;
+using namespace config::tests;
+using namespace config::filesystem;
+
+namespace
+{
+std::atomic<std::size_t> allocationCount{0};
+
+const auto projectRootPath = FileSystemService::getExecutablePath();
+const auto testConfigDirectory = projectRootPath.parent_path() / "testAllocationConfig";
+const auto defaultConfigFilePath = testConfigDirectory / "default.json";
+
+const std::string defaultJson = R"(
+{
+    "db": {
+        "host": "localhost",
+        "port": 3306
+    },
+    "aws": {
+        "region": "eu-west-1"
+    },
+    "auth": {
+        "roles": [
+            "admin",
+            "user"
+        ]
+    }
+}
+)";
+}
+
+// Every allocation of this test binary is counted, so tests can check that a read path does not allocate. The
+// replacements live in their own binary to leave the allocator of the other tests alone.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+class ConfigAllocationTest : public Test
+{
+public:
+    void SetUp() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "default");
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+        std::filesystem::remove_all(testConfigDirectory);
+
+        std::filesystem::create_directory(testConfigDirectory);
+
+        std::ofstream defaultConfigFile{defaultConfigFilePath};
+
+        defaultConfigFile << defaultJson;
+    }
+
+    void TearDown() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "");
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", "");
+
+        std::filesystem::remove_all(testConfigDirectory);
+    }
+};
+
+TEST_F(ConfigAllocationTest, getView_givenStringsAndArrays_returnsViewsWithoutAllocating)
+{
+    Config config;
+
+    // The first read loads the config
+    ASSERT_TRUE(config.has("db.host"));
+
+    const auto allocationsBefore = allocationCount.load();
+
+    const auto host = config.get<std::string_view>("db.host");
+    const auto region = config.getOptional<std::string_view>("aws.region");
+    const auto roles = config.get<std::span<const std::string_view>>("auth.roles");
+    const auto missing = config.getOptional<std::string_view>("redis.host");
+
+    const auto allocations = allocationCount.load() - allocationsBefore;
+
+    ASSERT_EQ(allocations, 0u);
+    ASSERT_EQ(host, "localhost");
+    ASSERT_EQ(region, "eu-west-1");
+    ASSERT_EQ(roles.size(), 2u);
+    ASSERT_EQ(roles[0], "admin");
+    ASSERT_EQ(missing, std::nullopt);
+    ASSERT_EQ(config.get<std::string_view>("db.host").data(), host.data());
+    ASSERT_THROW(config.get<std::string_view>("db.port"), std::runtime_error);
+}
@@ -0,0 +1,125 @@
+#include "config-cxx/config.h"
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "config-cxx-embedded/testEmbeddedConfig.h"
+
+using namespace ::testing;
+using namespace config;
+
+namespace
+{
+struct DbSettings
+{
+    std::string host;
+    int port = 0;
+    bool ssl = false;
+    double timeout = 0;
+    std::optional<std::string> user;
+};
+
+CONFIG_CXX_DESCRIBE(DbSettings, host, port, ssl, timeout, user);
+
+struct ServerSettings
+{
+    std::string host;
+    int port = 0;
+};
+
+CONFIG_CXX_DESCRIBE(ServerSettings, host, port);
+
+struct PortSettings
+{
+    std::vector<int> ports;
+    std::vector<double> weights;
+    std::vector<bool> flags;
+};
+
+CONFIG_CXX_DESCRIBE(PortSettings, ports, weights, flags);
+
+struct RedisSettings
+{
+    std::string host;
+};
+
+CONFIG_CXX_DESCRIBE(RedisSettings, host);
+
+struct AppSettings
+{
+    DbSettings db;
+    PortSettings server;
+    std::vector<ServerSettings> servers;
+    std::optional<RedisSettings> redis;
+};
+
+CONFIG_CXX_DESCRIBE(AppSettings, db, server, servers, redis);
+
+struct MistypedSettings
+{
+    int host = 0;
+    std::vector<int> port;
+    bool ssl = false;
+    std::string password;
+};
+
+CONFIG_CXX_DESCRIBE(MistypedSettings, host, port, ssl, password);
+
+// The embedded table is generated at build time from tests/embedded_config for CXX_ENV=production
+TEST(ConfigBindTest, bind_givenDescribedStruct_readsFieldsRelativeToPath)
+{
+    Config config{embedded::testEmbeddedConfig};
+
+    const auto db = config.bind<DbSettings>("db");
+
+    ASSERT_EQ(db.host, "db.production");
+    ASSERT_EQ(db.port, 5432);
+    ASSERT_TRUE(db.ssl);
+    ASSERT_EQ(db.timeout, 2.5);
+    ASSERT_EQ(db.user, std::nullopt);
+    ASSERT_EQ(config.bind<ServerSettings>("servers[1]").port, 8081);
+}
+
+TEST(ConfigBindTest, bind_givenNestedStructs_readsTheirSubtrees)
+{
+    Config config{embedded::testEmbeddedConfig};
+
+    const auto app = config.bind<AppSettings>("");
+
+    ASSERT_EQ(app.db.host, "db.production");
+    ASSERT_EQ(app.server.ports, (std::vector<int>{80, 443}));
+    ASSERT_EQ(app.server.weights, (std::vector<double>{0.5, 1.5}));
+    ASSERT_EQ(app.server.flags, (std::vector<bool>{true, false}));
+    ASSERT_EQ(app.servers.size(), 2u);
+    ASSERT_EQ(app.servers[0].host, "alpha");
+    ASSERT_EQ(app.servers[1].port, 8081);
+    ASSERT_FALSE(app.redis.has_value());
+}
+
+TEST(ConfigBindTest, bind_givenMissingAndMistypedFields_throwsListingAllOfThem)
+{
+    Config config{embedded::testEmbeddedConfig};
+
+    try
+    {
+        config.bind<MistypedSettings>("db");
+        FAIL() << "Expected std::runtime_error";
+    }
+    catch (const std::runtime_error& error)
+    {
+        const std::string message = error.what();
+
+        ASSERT_NE(message.find("Failed to bind 3 configuration key(s) of 'db'"), std::string::npos);
+        ASSERT_NE(message.find("'db.host' has wrong type"), std::string::npos);
+        ASSERT_NE(message.find("'db.port' has wrong type"), std::string::npos);
+        ASSERT_NE(message.find("'db.password' not found"), std::string::npos);
+    }
+
+    ASSERT_THROW(config.bind<DbSettings>("redis"), std::runtime_error);
+    ASSERT_THROW(config.bind<AppSettings>("db"), std::runtime_error);
+}
+}
@@ -0,0 +1,170 @@
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "config-cxx/config.h"
+#include "environment_setter.h"
+#include "file_system_service.h"
+
+using namespace ::testing;
+using namespace config;
+using namespace config::tests;
+using namespace config::filesystem;
+
+namespace
+{
+const auto projectRootPath = FileSystemService::getExecutablePath();
+const auto testConfigDirectory = projectRootPath.parent_path() / "testConfigKeys";
+const auto defaultConfigFilePath = testConfigDirectory / "default.json";
+
+const std::string defaultJson = R"(
+{
+    "db": {
+        "host": "localhost",
+        "port": 3306
+    },
+    "auth": {
+        "enabled": true,
+        "roles": [
+            "admin",
+            "user"
+        ]
+    }
+}
+)";
+
+const ConfigKey<int> declaredDbPort{"db.port"};
+const ConfigKey<std::string> declaredDbHost{"db.host"};
+}
+
+class ConfigKeyTest : public Test
+{
+public:
+    void SetUp() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "default");
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+        std::filesystem::remove_all(testConfigDirectory);
+
+        std::filesystem::create_directory(testConfigDirectory);
+
+        std::ofstream defaultConfigFile{defaultConfigFilePath};
+
+        defaultConfigFile << defaultJson;
+    }
+
+    void TearDown() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "");
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", "");
+
+        std::filesystem::remove_all(testConfigDirectory);
+    }
+};
+
+TEST_F(ConfigKeyTest, handle_returnsResolvedKey)
+{
+    Config config;
+
+    const auto dbPort = config.handle<int>("db.port");
+    const auto dbHost = config.handle<std::string>("db.host");
+    const auto authEnabled = config.handle<bool>("auth.enabled");
+    const auto authRoles = config.handle<std::vector<std::string>>("auth.roles");
+
+    ASSERT_TRUE(dbPort.isResolved());
+    ASSERT_EQ(dbPort.getKeyPath(), "db.port");
+    ASSERT_EQ(dbPort.get(), 3306);
+    ASSERT_EQ(*dbHost, "localhost");
+    ASSERT_EQ(dbHost->size(), 9u);
+    ASSERT_TRUE(authEnabled.get());
+    ASSERT_EQ(authRoles.get(), (std::vector<std::string>{"admin", "user"}));
+}
+
+TEST_F(ConfigKeyTest, handle_givenNotExistingKey_shouldThrow)
+{
+    Config config;
+
+    ASSERT_THROW(config.handle<int>("db.user"), std::runtime_error);
+}
+
+TEST_F(ConfigKeyTest, handle_givenWrongType_shouldThrow)
+{
+    Config config;
+
+    ASSERT_THROW(config.handle<int>("db.host"), std::runtime_error);
+}
+
+TEST_F(ConfigKeyTest, get_givenNotResolvedKey_shouldThrow)
+{
+    const ConfigKey<int> dbPort{"db.port"};
+
+    ASSERT_FALSE(dbPort.isResolved());
+    ASSERT_THROW(dbPort.get(), std::runtime_error);
+}
+
+TEST_F(ConfigKeyTest, resolveKeys_resolvesKeysDeclaredAtNamespaceScope)
+{
+    Config config;
+
+    config.resolveKeys();
+
+    ASSERT_EQ(declaredDbPort.get(), 3306);
+    ASSERT_EQ(declaredDbHost.get(), "localhost");
+}
+
+TEST_F(ConfigKeyTest, resolveKeys_reportsAllInvalidKeysInOneError)
+{
+    Config config;
+
+    const ConfigKey<int> dbUser{"db.user"};
+    const ConfigKey<int> dbHost{"db.host"};
+    const ConfigKey<bool> authEnabled{"auth.enabled"};
+
+    try
+    {
+        config.resolveKeys();
+        FAIL() << "Expected std::runtime_error";
+    }
+    catch (const std::runtime_error& e)
+    {
+        const std::string errorMsg = e.what();
+
+        ASSERT_NE(errorMsg.find("Failed to resolve 2 configuration key(s)"), std::string::npos) << errorMsg;
+        ASSERT_NE(errorMsg.find("'db.user' not found"), std::string::npos) << errorMsg;
+        ASSERT_NE(errorMsg.find("'db.host' has wrong type"), std::string::npos) << errorMsg;
+    }
+
+    ASSERT_TRUE(authEnabled.isResolved());
+    ASSERT_FALSE(dbUser.isResolved());
+}
+
+TEST_F(ConfigKeyTest, resolveKeys_doesNotResolveHandlesOfOtherConfigs)
+{
+    const auto dbPort = Config{}.handle<int>("db.port");
+    const auto dbPortCopy = dbPort;
+
+    std::ofstream{defaultConfigFilePath} << R"({"db": {"host": "db-2", "port": 5432}})";
+
+    Config config;
+
+    config.resolveKeys();
+
+    ASSERT_EQ(declaredDbPort.get(), 5432);
+    ASSERT_EQ(dbPort.get(), 3306);
+    ASSERT_EQ(dbPortCopy.get(), 3306);
+}
+
+TEST_F(ConfigKeyTest, copiedKey_keepsResolvedValue)
+{
+    Config config;
+
+    const auto dbPort = config.handle<int>("db.port");
+    const auto dbPortCopy = dbPort;
+
+    ASSERT_EQ(dbPortCopy.get(), 3306);
+}
@@ -109,3 +109,15 @@ TEST_F(ConfigProviderTest, getCxxConfigDir_returnsNullOptWhenEmpty)
     
     ASSERT_FALSE(configDir);
 }
+
+TEST_F(ConfigProviderTest, environmentSnapshot_returnsVariablesSetBeforeCapture)
+{
+    EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_SNAPSHOT_TEST", "before");
+
+    const auto environment = EnvironmentSnapshot::capture();
+
+    EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_SNAPSHOT_TEST", "after");
+
+    ASSERT_EQ(environment.getVariable("CONFIG_CXX_SNAPSHOT_TEST"), "before");
+    ASSERT_FALSE(environment.getVariable("NOT_EXISTING_ENV_VARIABLE"));
+}
@@ -0,0 +1,380 @@
+#include "config_store.h"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "binary_buffer.h"
+
+using namespace ::testing;
+using namespace config;
+
+namespace
+{
+std::vector<std::string> getKeys(std::span<const ConfigStore::Entry> entries)
+{
+    std::vector<std::string> keys;
+
+    for (const auto& entry : entries)
+    {
+        keys.emplace_back(entry.key);
+    }
+
+    return keys;
+}
+
+std::unordered_map<std::string, ConfigValue> createValues()
+{
+    std::unordered_map<std::string, ConfigValue> values = {
+        {"db.host", "localhost"}, {"db.port", 3306},         {"dbx.port", 1},
+        {"db", "db"},             {"auth.enabled", true},    {"auth.roles.0", "admin"},
+        {"auth.roles.1", "user"}, {"auth.roles.2", "guest"}, {"auth.rolesCount", 3}};
+
+    for (int index = 3; index <= 11; ++index)
+    {
+        values["auth.roles." + std::to_string(index)] = "role" + std::to_string(index);
+    }
+
+    return values;
+}
+
+class CountingMemoryResource : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations = 0;
+    std::size_t outstandingAllocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        ++outstandingAllocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override
+    {
+        --outstandingAllocations;
+        std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+}
+
+TEST(ConfigStoreTest, find_givenExistingKey_returnsValue)
+{
+    const ConfigStore store{createValues()};
+
+    const auto* value = store.find("db.port");
+
+    ASSERT_NE(value, nullptr);
+    ASSERT_EQ(value->toConfigValue(), ConfigValue{3306});
+    ASSERT_EQ(store.find("db.user"), nullptr);
+}
+
+TEST(ConfigStoreTest, getEntries_returnsKeysSortedBySegmentsWithNumericIndices)
+{
+    const ConfigStore store{{{"b.10", 1}, {"b.9", 2}, {"a", 3}, {"b", 4}, {"a.b", 5}, {"a-b", 6}, {"b.x", 7}}};
+
+    const auto expectedKeys = std::vector<std::string>{"a", "a.b", "a-b", "b", "b.9", "b.10", "b.x"};
+
+    ASSERT_EQ(getKeys(store.getEntries()), expectedKeys);
+}
+
+TEST(ConfigStoreTest, getEntries_givenMixedNumericAndTextSegments_sortsNumericSegmentsFirst)
+{
+    std::unordered_map<std::string, ConfigValue> values;
+
+    for (const auto* segment : {"2", "10", "1a", "3", "20", "1b", "100", "9z", "a"})
+    {
+        values.emplace("x." + std::string{segment} + ".v", segment);
+    }
+
+    const ConfigStore store{std::move(values)};
+
+    const auto expectedKeys = std::vector<std::string>{"x.2.v",  "x.3.v",  "x.10.v", "x.20.v", "x.100.v",
+                                                       "x.1a.v", "x.1b.v", "x.9z.v", "x.a.v"};
+
+    ASSERT_EQ(getKeys(store.getEntries()), expectedKeys);
+    ASSERT_EQ(getKeys(store.findChildren("x")), expectedKeys);
+    ASSERT_EQ(store.findChildren("x.2").size(), 1u);
+
+    for (const auto& key : expectedKeys)
+    {
+        ASSERT_NE(store.find(key), nullptr);
+        ASSERT_TRUE(store.contains(key.substr(0, key.size() - 2)));
+    }
+}
+
+TEST(ConfigStoreTest, findChildren_returnsNestedKeysInOrder)
+{
+    const ConfigStore store{createValues()};
+
+    const auto children = store.findChildren("auth.roles");
+
+    ASSERT_EQ(children.size(), 12u);
+    ASSERT_EQ(children.front().key, "auth.roles.0");
+    ASSERT_EQ(children.front().value->toConfigValue(), ConfigValue{"admin"});
+    ASSERT_EQ(children[10].key, "auth.roles.10");
+    ASSERT_EQ(children.back().key, "auth.roles.11");
+}
+
+TEST(ConfigStoreTest, findChildren_doesNotIncludeKeyItselfOrKeysSharingTextPrefix)
+{
+    const ConfigStore store{createValues()};
+
+    const auto expectedKeys = std::vector<std::string>{"db.host", "db.port"};
+
+    ASSERT_EQ(getKeys(store.findChildren("db")), expectedKeys);
+    ASSERT_TRUE(store.findChildren("auth.enabled").empty());
+    ASSERT_TRUE(store.findChildren("redis").empty());
+}
+
+TEST(ConfigStoreTest, contains_givenKeyOrObjectPrefix_returnsTrue)
+{
+    const ConfigStore store{createValues()};
+
+    ASSERT_TRUE(store.contains("db.host"));
+    ASSERT_TRUE(store.contains("auth"));
+    ASSERT_TRUE(store.contains("auth.roles"));
+    ASSERT_FALSE(store.contains("auth.role"));
+    ASSERT_FALSE(store.contains("redis"));
+}
+
+TEST(ConfigStoreTest, givenKeysBelowIndices_storesArrayMarkerWithElementCount)
+{
+    const ConfigStore store{{{"servers.0.host", "alpha"},
+                             {"servers.1.host", "beta"},
+                             {"servers.1.port", 8081},
+                             {"servers.2.host", "gamma"},
+                             {"gaps.0.host", "alpha"},
+                             {"gaps.2.host", "gamma"},
+                             {"mixed.0", 1},
+                             {"mixed.name", "x"}}};
+
+    const auto* servers = store.find("servers");
+
+    ASSERT_NE(servers, nullptr);
+    ASSERT_EQ(servers->getType(), CompactValue::Type::ObjectArray);
+    ASSERT_EQ(servers->getArraySize(), 3u);
+    ASSERT_EQ(store.findChildren("servers").size(), 4u);
+    ASSERT_EQ(store.find("gaps"), nullptr);
+    ASSERT_EQ(store.find("mixed"), nullptr);
+    ASSERT_EQ(store.findValue("servers[1].port")->toConfigValue(), ConfigValue{8081});
+}
+
+TEST(ConfigStoreTest, findValue_givenSubtree_looksUpKeysRelativeToPrefix)
+{
+    const ConfigStore store{{{"servers.0.host", "alpha"}, {"servers.0.ports", std::vector<int>{1, 2}},
+                             {"servers.1.host", "beta"}}};
+
+    const auto element = store.findSubtree(store.getEntries(), 0, "servers.0");
+
+    ASSERT_EQ(element.size(), 2u);
+    ASSERT_EQ(store.findValue(element, 9, "host")->toConfigValue(), ConfigValue{"alpha"});
+    ASSERT_EQ(store.findValue(element, 9, "ports[1]")->toConfigValue(), ConfigValue{2});
+    ASSERT_FALSE(store.findValue(element, 9, "port").has_value());
+    ASSERT_TRUE(store.findSubtree(element, 9, "user").empty());
+}
+
+TEST(ConfigStoreTest, find_givenStringViewOrKeyPath_returnsValue)
+{
+    using namespace config::literals;
+
+    const ConfigStore store{createValues()};
+
+    const std::string_view dbHostKey = "db.host";
+
+    ASSERT_EQ(store.find(dbHostKey)->toConfigValue(), ConfigValue{"localhost"});
+    ASSERT_EQ(store.find("db.port"_ck)->toConfigValue(), ConfigValue{3306});
+    ASSERT_EQ(store.find("db.user"_ck), nullptr);
+}
+
+TEST(ConfigStoreTest, find_givenManyKeys_findsEveryKey)
+{
+    std::unordered_map<std::string, ConfigValue> values;
+
+    for (int index = 0; index < 10000; ++index)
+    {
+        values["section" + std::to_string(index / 16) + ".key" + std::to_string(index % 16)] = index;
+    }
+
+    const ConfigStore store{values};
+
+    for (const auto& [key, value] : values)
+    {
+        const auto* foundValue = store.find(key);
+
+        ASSERT_NE(foundValue, nullptr) << key;
+        ASSERT_EQ(foundValue->toConfigValue(), value) << key;
+    }
+
+    ASSERT_EQ(store.find("section0.key16"), nullptr);
+    ASSERT_EQ(store.find("section625.key0"), nullptr);
+    ASSERT_EQ(store.find(""), nullptr);
+}
+
+TEST(ConfigStoreTest, find_givenEmptyStore_returnsNull)
+{
+    const ConfigStore store{{}};
+
+    ASSERT_TRUE(store.empty());
+    ASSERT_EQ(store.find("db.host"), nullptr);
+    ASSERT_FALSE(store.contains("db"));
+}
+
+TEST(ConfigStoreTest, find_givenStringAndArrayValues_returnsValuesBackedByStore)
+{
+    const ConfigStore store{{{"db.host", "localhost"},
+                             {"auth.roles", std::vector<std::string>{"admin", "user"}},
+                             {"auth.empty", std::vector<std::string>{}},
+                             {"aws.accountId", nullptr}}};
+
+    ASSERT_EQ(store.find("db.host")->asString(), "localhost");
+    ASSERT_EQ(store.find("auth.roles")->toConfigValue(), (ConfigValue{std::vector<std::string>{"admin", "user"}}));
+    ASSERT_TRUE(store.find("auth.empty")->asStringArray().empty());
+    ASSERT_TRUE(store.find("aws.accountId")->isNull());
+}
+
+TEST(ConfigStoreTest, constructor_givenMemoryResource_keepsAllValuesInOneAllocation)
+{
+    CountingMemoryResource memoryResource;
+    std::unordered_map<std::string, ConfigValue> values;
+
+    for (int index = 0; index < 10000; ++index)
+    {
+        values["section" + std::to_string(index / 16) + ".key" + std::to_string(index % 16)] =
+            "value" + std::to_string(index);
+    }
+
+    values["auth.roles"] = std::vector<std::string>{"admin", "user"};
+
+    {
+        const ConfigStore store{values, &memoryResource};
+
+        ASSERT_EQ(memoryResource.outstandingAllocations, 1);
+        ASSERT_LE(memoryResource.allocations, 2);
+        ASSERT_EQ(store.find("section624.key15")->asString(), "value9999");
+        ASSERT_EQ(store.find("auth.roles")->asStringArray().size(), 2);
+    }
+
+    ASSERT_EQ(memoryResource.outstandingAllocations, 0);
+}
+
+TEST(ConfigStoreTest, constructor_givenRepeatedStrings_storesThemOnce)
+{
+    const ConfigStore store{{{"db.host", "localhost"},
+                             {"cache.host", "localhost"},
+                             {"hosts", std::vector<std::string>{"localhost", "remote"}},
+                             {"db.name", "remote"}}};
+
+    const auto host = store.find("db.host")->asString();
+
+    ASSERT_EQ(store.find("cache.host")->asString().data(), host.data());
+    ASSERT_EQ(store.find("hosts")->asStringArray()[0].data(), host.data());
+    ASSERT_EQ(store.find("hosts")->asStringArray()[1].data(), store.find("db.name")->asString().data());
+}
+
+TEST(ConfigStoreTest, constructor_givenBorrowedStrings_keepsValuesInTheirOwner)
+{
+    const auto certificate = std::make_shared<const std::string>("-----BEGIN CERTIFICATE-----");
+    BorrowedStrings borrowedStrings;
+    borrowedStrings.values["tls.certificate"] = *certificate;
+    borrowedStrings.values["tls.stale"] = *certificate;
+    borrowedStrings.owners.push_back(certificate);
+
+    // Only empty placeholders are replaced, a value stored after the string was borrowed is kept
+    const ConfigStore store{{{"tls.certificate", ""}, {"tls.stale", "override"}, {"tls.enabled", true}},
+                            std::pmr::get_default_resource(), std::move(borrowedStrings)};
+
+    ASSERT_EQ(store.find("tls.certificate")->asString(), "-----BEGIN CERTIFICATE-----");
+    ASSERT_EQ(store.find("tls.certificate")->asString().data(), certificate->data());
+    ASSERT_EQ(store.find("tls.stale")->asString(), "override");
+    ASSERT_EQ(certificate.use_count(), 2);
+}
+
+TEST(ConfigStoreTest, constructor_givenImage_restoresValuesAndLookups)
+{
+    const auto certificate = std::make_shared<const std::string>("-----BEGIN CERTIFICATE-----");
+    BorrowedStrings borrowedStrings;
+    borrowedStrings.values["tls.certificate"] = *certificate;
+    borrowedStrings.owners.push_back(certificate);
+
+    const ConfigStore store{{{"db.host", "localhost"},
+                             {"db.port", 1996},
+                             {"db.ratio", 0.5},
+                             {"db.scale", 1.5f},
+                             {"db.enabled", true},
+                             {"aws.accountId", nullptr},
+                             {"auth.roles", std::vector<std::string>{"admin", "user"}},
+                             {"server.ports", std::vector<int>{80, 443}},
+                             {"server.weights", std::vector<double>{0.25}},
+                             {"server.flags", std::vector<bool>{true, false}},
+                             {"servers.0.host", "alpha"},
+                             {"servers.1.host", "localhost"},
+                             {"tls.certificate", ""}},
+                            std::pmr::get_default_resource(), std::move(borrowedStrings)};
+
+    std::string image;
+    BinaryWriter writer{image};
+    store.write(writer);
+
+    BinaryReader reader{image};
+    const ConfigStore restoredStore{reader, std::pmr::get_default_resource()};
+
+    ASSERT_TRUE(reader.atEnd());
+    ASSERT_EQ(getKeys(restoredStore.getEntries()), getKeys(store.getEntries()));
+
+    for (const auto& entry : store.getEntries())
+    {
+        ASSERT_EQ(restoredStore.find(entry.key)->toConfigValue(), entry.value->toConfigValue()) << entry.key;
+    }
+
+    // Borrowed strings are copied into the image, so the restored store does not depend on their owner
+    ASSERT_NE(restoredStore.find("tls.certificate")->asString().data(), certificate->data());
+    ASSERT_EQ(restoredStore.findValue("server.ports[1]")->asInt(), 443);
+    ASSERT_EQ(restoredStore.find("servers")->getArraySize(), 2);
+    ASSERT_EQ(restoredStore.findChildren("servers").size(), store.findChildren("servers").size());
+}
+
+TEST(ConfigStoreTest, constructor_givenTruncatedImage_throws)
+{
+    const ConfigStore store{{{"db.host", "localhost"}, {"auth.roles", std::vector<std::string>{"admin", "user"}}}};
+
+    std::string image;
+    BinaryWriter writer{image};
+    store.write(writer);
+    image.resize(image.size() - 1);
+
+    BinaryReader reader{image};
+
+    ASSERT_THROW((ConfigStore{reader, std::pmr::get_default_resource()}), std::runtime_error);
+}
+
+TEST(ConfigStoreTest, findValue_givenArrayIndex_returnsElement)
+{
+    const ConfigStore store{{{"server.ports", std::vector<int>{8080, 8081, 8082}},
+                             {"server.flags", std::vector<bool>{true, false}},
+                             {"roles.0", "admin"}}};
+
+    ASSERT_EQ(store.findValue("server.ports[2]")->asInt(), 8082);
+    ASSERT_EQ(store.findValue("server.ports.1")->asInt(), 8081);
+    ASSERT_FALSE(store.findValue("server.flags[1]")->asBool());
+    ASSERT_EQ(store.findValue("roles[0]")->asString(), "admin");
+    ASSERT_FALSE(store.findValue("server.ports[3]").has_value());
+    ASSERT_FALSE(store.findValue("server.ports[]").has_value());
+    ASSERT_FALSE(store.findValue("[0]").has_value());
+    ASSERT_EQ(store.find("server.ports[2]"), nullptr);
+    ASSERT_TRUE(store.contains("server.ports[0]"));
+}
@@ -0,0 +1,138 @@
+#include "config_struct_generator.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "config-cxx-embedded/testEmbeddedConfig.h"
+#include "config-cxx-generated/TestConfig.h"
+#include "file_system_service.h"
+
+using namespace ::testing;
+using namespace config;
+using namespace config::filesystem;
+using namespace config::generated;
+
+namespace
+{
+const auto projectRootPath = FileSystemService::getExecutablePath();
+const auto configStructGeneratorTestDirectory = projectRootPath.parent_path() / "configStructGeneratorTest";
+const auto schemaFilePath = configStructGeneratorTestDirectory / "default.json";
+
+constexpr EmbeddedEntry mistypedEntries[] = {
+    {.key = "db.host", .type = EmbeddedType::String, .number = 0, .text = "localhost", .numbers = {}, .texts = {}},
+    {.key = "db.port", .type = EmbeddedType::String, .number = 0, .text = "not a port", .numbers = {}, .texts = {}},
+};
+
+class ConfigStructGeneratorTest : public Test
+{
+public:
+    void SetUp() override
+    {
+        std::filesystem::remove_all(configStructGeneratorTestDirectory);
+        std::filesystem::create_directory(configStructGeneratorTestDirectory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(configStructGeneratorTestDirectory);
+    }
+
+    static std::string generate(const std::string& schema)
+    {
+        std::ofstream{schemaFilePath} << schema;
+
+        return ConfigStructGenerator::generate(schemaFilePath, "AppConfig", "app");
+    }
+};
+
+// TestConfig is generated at build time from tests/embedded_config/default.json
+TEST_F(ConfigStructGeneratorTest, load_givenConfig_readsEveryMember)
+{
+    Config config{embedded::testEmbeddedConfig};
+
+    const auto testConfig = TestConfig::load(config);
+
+    ASSERT_EQ(testConfig.db.host, "db.production");
+    ASSERT_EQ(testConfig.db.port, 5432);
+    ASSERT_TRUE(testConfig.db.ssl);
+    ASSERT_EQ(testConfig.auth.roles, (std::vector<std::string>{"admin", "user"}));
+    ASSERT_EQ(testConfig.server.ports, (std::vector<int>{80, 443}));
+    ASSERT_EQ(testConfig.server.weights, (std::vector<double>{0.5, 1.5}));
+    ASSERT_EQ(testConfig.server.flags, (std::vector<bool>{true, false}));
+    ASSERT_EQ(testConfig.servers.size(), 2);
+    ASSERT_EQ(testConfig.servers[1].host, "beta");
+    ASSERT_EQ(testConfig.servers[1].port, 8081);
+    ASSERT_EQ(testConfig.messages.greeting, "Say \"caf\u00e9\"\n\tto C:\\config");
+}
+
+TEST_F(ConfigStructGeneratorTest, load_givenMissingAndMistypedKeys_throwsListingAllOfThem)
+{
+    Config config{EmbeddedConfig{mistypedEntries}};
+
+    try
+    {
+        TestConfig::load(config);
+        FAIL() << "Expected std::runtime_error";
+    }
+    catch (const std::runtime_error& error)
+    {
+        const std::string message = error.what();
+
+        ASSERT_NE(message.find("Failed to load 8 configuration key(s) of TestConfig"), std::string::npos);
+        ASSERT_NE(message.find("'db.port' has wrong type"), std::string::npos);
+        ASSERT_NE(message.find("'servers' is not an array"), std::string::npos);
+        ASSERT_EQ(message.find("'db.host' not found"), std::string::npos);
+    }
+}
+
+TEST_F(ConfigStructGeneratorTest, generate_givenKeysThatAreNoIdentifiers_namesMembersAfterThem)
+{
+    const auto header =
+        generate(R"({"max-connections": 10, "class": "premium", "2fa": true, "aws": {"accountId": null}})");
+
+    ASSERT_NE(header.find("int max_connections{};"), std::string::npos);
+    ASSERT_NE(header.find("std::string class_;"), std::string::npos);
+    ASSERT_NE(header.find("bool _2fa{};"), std::string::npos);
+    ASSERT_NE(header.find(R"(read(result.max_connections, "max-connections");)"), std::string::npos);
+    ASSERT_NE(header.find("// 'aws.accountId' is null in the schema"), std::string::npos);
+    ASSERT_NE(header.find("namespace app"), std::string::npos);
+}
+
+TEST_F(ConfigStructGeneratorTest, generate_givenTopLevelKeyNamedLoad_renamesItsMember)
+{
+    const auto header = generate(R"({"load": "high", "jobs": {"load": 2}})");
+
+    ASSERT_NE(header.find("std::string load_;"), std::string::npos);
+    ASSERT_NE(header.find(R"(read(result.load_, "load");)"), std::string::npos);
+    ASSERT_NE(header.find("static AppConfig load(config::Config& config);"), std::string::npos);
+    // Nested structs have no load(), their members keep the name of the key
+    ASSERT_NE(header.find("int load{};"), std::string::npos);
+    ASSERT_NE(header.find(R"(read(result.jobs.load, "jobs.load");)"), std::string::npos);
+}
+
+TEST_F(ConfigStructGeneratorTest, generate_givenKeysNamedLoadAndLoadWithUnderscore_throws)
+{
+    ASSERT_THROW(generate(R"({"load": 1, "load_": 2})"), std::runtime_error);
+}
+
+TEST_F(ConfigStructGeneratorTest, generate_givenArrayOfObjects_mergesTheKeysOfAllElements)
+{
+    const auto header = generate(R"({"servers": [{"host": "alpha", "weight": 1}, {"port": 8081, "weight": 0.5}]})");
+
+    ASSERT_NE(header.find("struct ServersElement"), std::string::npos);
+    ASSERT_NE(header.find("std::string host;"), std::string::npos);
+    ASSERT_NE(header.find("int port{};"), std::string::npos);
+    ASSERT_NE(header.find("double weight{};"), std::string::npos);
+    ASSERT_NE(header.find("std::vector<ServersElement> servers;"), std::string::npos);
+}
+
+TEST_F(ConfigStructGeneratorTest, generate_givenElementsOfDifferentTypes_throws)
+{
+    ASSERT_THROW(generate(R"({"servers": [{"port": 8080}, {"port": "8081"}]})"), std::runtime_error);
+}
+}
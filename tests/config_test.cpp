@@ -1,10 +1,18 @@
 #include "config-cxx/config.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
 #include <optional>
+#include <span>
 #include <fstream>
+#include <iterator>
+#include <memory_resource>
 #include <stdexcept>
+#include <string_view>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -561,3 +569,690 @@ TEST_F(ConfigTest, betterErrorMessages_showsTypeInformation)
             << "Error message should mention type mismatch: " << errorMsg;
     }
 }
+
+TEST_F(ConfigTest, concurrentReads_returnSameValuesAsSingleThreadedReads)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    Config config;
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+
+    for (int threadIndex = 0; threadIndex < 8; ++threadIndex)
+    {
+        threads.emplace_back(
+            [&config, &mismatches]
+            {
+                for (int iteration = 0; iteration < 1000; ++iteration)
+                {
+                    if (config.get<int>("db.port") != 1996 || config.get<std::string>("db.host") != "localhost" ||
+                        !config.has("auth.enabled") || config.getOptional<int>("redis.port").has_value())
+                    {
+                        ++mismatches;
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(mismatches, 0);
+}
+
+TEST_F(ConfigTest, has_givenObjectPrefix_returnsTrue)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    Config config;
+
+    ASSERT_TRUE(config.has("db"));
+    ASSERT_TRUE(config.has("auth.roles"));
+    ASSERT_FALSE(config.has("d"));
+    ASSERT_FALSE(config.has("redis"));
+}
+
+TEST_F(ConfigTest, getArray_returnsElementsInSourceOrder)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::ofstream{testEnvConfigFilePath} << R"({"ports": [10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21]})";
+
+    Config config;
+
+    const auto expectedPorts =
+        std::vector<std::string>{"10", "11", "12", "13", "14", "15", "16", "17", "18", "19", "20", "21"};
+
+    ASSERT_EQ(config.get<std::vector<std::string>>("ports"), expectedPorts);
+    ASSERT_EQ(std::get<std::vector<int>>(config.get("ports")),
+              (std::vector<int>{10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21}));
+}
+
+TEST_F(ConfigTest, get_givenNumericArrays_returnsElementsInNativeType)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::ofstream{testEnvConfigFilePath} << R"({
+        "ports": [8080, 8081, 8082],
+        "weights": [0.25, 0.5, 1],
+        "flags": [true, false, true],
+        "hosts": ["alpha", "beta"],
+        "mixed": [1, "two", null]
+    })";
+
+    Config config;
+
+    ASSERT_EQ(config.get<std::vector<int>>("ports"), (std::vector<int>{8080, 8081, 8082}));
+    ASSERT_EQ(config.get<std::vector<double>>("weights"), (std::vector<double>{0.25, 0.5, 1.0}));
+    ASSERT_EQ(config.get<std::vector<double>>("ports"), (std::vector<double>{8080.0, 8081.0, 8082.0}));
+    ASSERT_EQ(config.get<std::vector<bool>>("flags"), (std::vector<bool>{true, false, true}));
+    ASSERT_EQ(config.get<std::vector<std::string>>("mixed"), (std::vector<std::string>{"1", "two", "nullptr"}));
+
+    const auto ports = config.get<std::span<const int>>("ports");
+    const auto weights = config.get<std::span<const double>>("weights");
+
+    ASSERT_EQ(std::vector<int>(ports.begin(), ports.end()), (std::vector<int>{8080, 8081, 8082}));
+    ASSERT_EQ(weights.size(), 3);
+    ASSERT_EQ(weights[0], 0.25);
+    ASSERT_EQ(config.get<std::span<const bool>>("flags").size(), 3);
+    ASSERT_EQ(config.get<std::span<const std::string_view>>("hosts")[1], "beta");
+    ASSERT_EQ(config.get<std::span<const int>>("ports").data(), ports.data());
+    ASSERT_THROW(config.get<std::span<const int>>("weights"), std::runtime_error);
+    ASSERT_THROW(config.get<std::vector<int>>("hosts"), std::runtime_error);
+}
+
+TEST_F(ConfigTest, get_givenEmptyArrays_returnsEmptyArraysOfAnyElementType)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::ofstream{testEnvConfigFilePath} << R"({"server": {"ports": []}})";
+    std::ofstream{testYamlEnvConfigFilePath} << "server:\n  weights: []\n";
+
+    Config config;
+
+    for (const auto* keyPath : {"server.ports", "server.weights"})
+    {
+        EXPECT_TRUE(config.get<std::vector<int>>(keyPath).empty()) << keyPath;
+        EXPECT_TRUE(config.get<std::vector<double>>(keyPath).empty()) << keyPath;
+        EXPECT_TRUE(config.get<std::vector<std::string>>(keyPath).empty()) << keyPath;
+        EXPECT_TRUE(config.get<std::span<const int>>(keyPath).empty()) << keyPath;
+        EXPECT_TRUE(config.get<std::span<const bool>>(keyPath).empty()) << keyPath;
+    }
+}
+
+TEST_F(ConfigTest, get_givenArrayIndex_returnsElement)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::ofstream{testEnvConfigFilePath} << R"({"server": {"ports": [8080, 8081, 8082], "hosts": ["alpha", "beta"]}})";
+
+    Config config;
+
+    ASSERT_EQ(config.get<int>("server.ports[2]"), 8082);
+    ASSERT_EQ(config.get<int>("server.ports.0"), 8080);
+    ASSERT_EQ(config.get<std::string>("server.hosts[1]"), "beta");
+    ASSERT_EQ(config.getOptional<int>("server.ports[3]"), std::nullopt);
+    ASSERT_TRUE(config.has("server.ports[1]"));
+    ASSERT_FALSE(config.has("server.ports[3]"));
+    ASSERT_FALSE(config.has("server.ports[x]"));
+    ASSERT_THROW(config.get<int>("server.ports[3]"), std::runtime_error);
+}
+
+TEST_F(ConfigTest, givenArraysOfObjects_readsElementsByIndexAndIteration)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::ofstream{testEnvConfigFilePath} << R"({
+        "servers": [
+            {"host": "alpha", "port": 8080, "tags": ["a", "b"]},
+            {"host": "beta", "port": 8081}
+        ]
+    })";
+    std::ofstream{testYamlEnvConfigFilePath} << R"(
+workers:
+    - name: w0
+      threads: 2
+    - name: w1
+      threads: 4
+)";
+    std::ofstream{testXmlEnvConfigFilePath} << R"(
+<configuration>
+    <nodes>
+        <node><id>1</id></node>
+        <node><id>2</id></node>
+        <node><id>3</id></node>
+    </nodes>
+</configuration>
+)";
+
+    Config config;
+
+    ASSERT_EQ(config.get<int>("servers[1].port"), 8081);
+    ASSERT_EQ(config.get<std::string>("servers.0.host"), "alpha");
+    ASSERT_EQ(config.get<std::string>("servers[0].tags[1]"), "b");
+    ASSERT_EQ(config.size("servers"), 2u);
+    ASSERT_EQ(config.size("servers[0].tags"), 2u);
+    ASSERT_EQ(config.get<int>("workers[1].threads"), 4);
+    ASSERT_EQ(config.size("workers"), 2u);
+    ASSERT_EQ(config.get<int>("nodes[2].id"), 3);
+    ASSERT_EQ(config.size("nodes"), 3u);
+    ASSERT_THROW(config.size("servers[0].host"), std::runtime_error);
+    ASSERT_THROW(config.elements("servers[0].tags"), std::runtime_error);
+
+    std::vector<std::string> hosts;
+    std::vector<int> ports;
+
+    for (const auto& server : config.elements("servers"))
+    {
+        hosts.push_back(server.get<std::string>("host"));
+        ports.push_back(server.get<int>("port"));
+    }
+
+    ASSERT_EQ(hosts, (std::vector<std::string>{"alpha", "beta"}));
+    ASSERT_EQ(ports, (std::vector<int>{8080, 8081}));
+
+    const auto servers = config.elements("servers");
+    const auto first = *servers.begin();
+
+    ASSERT_EQ(servers.size(), 2u);
+    ASSERT_EQ(std::distance(servers.begin(), servers.end()), 2);
+    ASSERT_EQ(first.getKeyPath(), "servers.0");
+    ASSERT_EQ(first.get<std::string>("tags[0]"), "a");
+    ASSERT_TRUE(first.has("tags"));
+    ASSERT_FALSE(first.has("user"));
+    ASSERT_EQ(first.getOptional<int>("user"), std::nullopt);
+    ASSERT_THROW(first.get<int>("user"), std::runtime_error);
+
+    int threads = 0;
+
+    for (const auto& worker : config.elements("workers"))
+    {
+        threads += worker.get<int>("threads");
+    }
+
+    ASSERT_EQ(threads, 6);
+    ASSERT_EQ(std::distance(config.elements("nodes").begin(), config.elements("nodes").end()), 3);
+}
+
+TEST_F(ConfigTest, view_givenPrefix_readsKeysRelativeToIt)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::ofstream{testEnvConfigFilePath} << R"({
+        "services": {
+            "billing": {"timeout": 30, "retry": {"max": 5, "delays": [1, 2]}, "url": "http://billing"},
+            "shipping": {"timeout": 10},
+            "billingLegacy": {"timeout": 60}
+        },
+        "servers": [{"host": "alpha", "port": 8080}, {"host": "beta", "port": 8081}]
+    })";
+
+    Config config;
+
+    const auto billing = config.view("services.billing");
+
+    ASSERT_EQ(billing.getKeyPath(), "services.billing");
+    ASSERT_EQ(billing.get<int>("timeout"), 30);
+    ASSERT_EQ(billing.get<int>("retry.max"), 5);
+    ASSERT_EQ(billing.view("retry").get<int>("delays[1]"), 2);
+    ASSERT_EQ(billing.view("retry").getKeyPath(), "services.billing.retry");
+    ASSERT_FALSE(billing.has("port"));
+    ASSERT_EQ(config.view("servers[0]").get<std::string>("host"), "alpha");
+    ASSERT_EQ(config.view("").view("services").get<int>("shipping.timeout"), 10);
+
+    // Nested views accept indices in brackets like Config::view(), even as the first segment of a relative path
+    ASSERT_EQ(config.view("").view("servers[1]").get<std::string>("host"), "beta");
+    ASSERT_EQ(config.view("").view("servers[1]").getKeyPath(), "servers.1");
+    ASSERT_EQ(config.view("servers").get<std::string>("[1].host"), "beta");
+    ASSERT_EQ(config.view("servers").view("[1]").get<int>("port"), 8081);
+    ASSERT_TRUE(config.view("servers").has("[1]"));
+
+    const auto services = config.view("services").children();
+    const auto billingChildren = billing.children();
+
+    ASSERT_EQ(std::vector<std::string_view>(services.begin(), services.end()),
+              (std::vector<std::string_view>{"billing", "billingLegacy", "shipping"}));
+    ASSERT_EQ(std::vector<std::string_view>(billingChildren.begin(), billingChildren.end()),
+              (std::vector<std::string_view>{"retry", "timeout", "url"}));
+
+    ASSERT_THROW(config.view("services.billing.timeout"), std::runtime_error);
+    ASSERT_THROW(config.view("services.payments"), std::runtime_error);
+    ASSERT_THROW(billing.view("url"), std::runtime_error);
+}
+
+TEST_F(ConfigTest, forEach_givenPrefix_visitsNestedValuesInKeyOrder)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::ofstream{testEnvConfigFilePath} << R"({
+        "db": {"port": 5432, "host": "localhost", "user": null, "replicas": ["a", "b"]},
+        "servers": [{"port": 8080}, {"port": 8081}, {"port": 8082}, {"port": 8083}, {"port": 8084},
+                    {"port": 8085}, {"port": 8086}, {"port": 8087}, {"port": 8088}, {"port": 8089}, {"port": 8090}]
+    })";
+
+    Config config;
+
+    std::vector<std::string_view> keys;
+    std::string host;
+    std::size_t replicas = 0;
+    std::size_t nulls = 0;
+
+    config.forEach("db",
+                   [&](std::string_view key, const ConfigValueRef& value)
+                   {
+                       keys.push_back(key);
+
+                       if (key == "db.host")
+                       {
+                           host = value.get<std::string_view>();
+                       }
+                       else if (key == "db.replicas")
+                       {
+                           replicas = value.get<std::span<const std::string_view>>().size();
+                       }
+
+                       nulls += value.isNull() ? 1 : 0;
+                   });
+
+    ASSERT_EQ(keys, (std::vector<std::string_view>{"db.host", "db.port", "db.replicas", "db.user"}));
+    ASSERT_EQ(host, "localhost");
+    ASSERT_EQ(replicas, 2u);
+    ASSERT_EQ(nulls, 1u);
+
+    const auto serverKeys = config.keys("servers");
+    const std::vector<std::string_view> servers(serverKeys.begin(), serverKeys.end());
+
+    ASSERT_EQ(servers.size(), 11u);
+    ASSERT_EQ(servers[2], "servers.2.port");
+    ASSERT_EQ(servers[10], "servers.10.port");
+
+    std::vector<int> ports;
+
+    config.forEach("servers[2]",
+                   [&](std::string_view, const ConfigValueRef& value) { ports.push_back(value.get<int>()); });
+
+    ASSERT_EQ(ports, (std::vector<int>{8082}));
+
+    const auto allKeys = config.keys("");
+    std::vector<std::string_view> visitedKeys;
+
+    config.forEach("", [&](std::string_view key, const ConfigValueRef&) { visitedKeys.push_back(key); });
+
+    ASSERT_EQ(std::vector<std::string_view>(allKeys.begin(), allKeys.end()), visitedKeys);
+    ASSERT_NE(std::find(visitedKeys.begin(), visitedKeys.end(), "db.host"), visitedKeys.end());
+
+    const auto missingKeys = config.keys("redis");
+
+    ASSERT_EQ(missingKeys.begin(), missingKeys.end());
+}
+
+TEST_F(ConfigTest, get_givenStringViewOrKeyLiteral_returnsKeyValues)
+{
+    using namespace config::literals;
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    Config config;
+
+    constexpr std::string_view dbPortKey = "db.port";
+    constexpr auto dbHostKey = "db.host"_ck;
+
+    static_assert(dbHostKey.getHash() == KeyPath::hashPath("db.host"));
+
+    ASSERT_EQ(config.get<int>(dbPortKey), 1996);
+    ASSERT_EQ(config.get<std::string>(dbHostKey), "localhost");
+    ASSERT_EQ(config.getOptional<int>("auth.expiresIn"_ck), 3600);
+    ASSERT_EQ(config.getOrDefault<int>("redis.port"_ck, 6379), 6379);
+    ASSERT_TRUE(config.has("aws.region"_ck));
+    ASSERT_THROW(config.get<int>("db.prot"_ck), std::runtime_error);
+}
+
+TEST_F(ConfigTest, givenConfigsForSameDirectoryAndEnv_shareLoadedValues)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    {
+        Config config;
+        Config other;
+
+        ASSERT_EQ(config.get<std::string_view>("db.host").data(), other.get<std::string_view>("db.host").data());
+
+        // Files are not read again while a config still refers to the loaded values
+        std::ofstream{testEnvConfigFilePath} << R"({"db": {"port": 1}})";
+
+        ASSERT_EQ(Config{}.get<int>("db.port"), 1996);
+
+        // Another environment gets its own store and reads the files as they are now
+        EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "development");
+
+        Config development;
+
+        ASSERT_EQ(development.get<int>("db.port"), 1);
+        ASSERT_NE(development.get<std::string_view>("db.host").data(), config.get<std::string_view>("db.host").data());
+    }
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+
+    ASSERT_EQ(Config{}.get<int>("db.port"), 1);
+}
+
+TEST_F(ConfigTest, load_loadsConfigBeforeFirstRead)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    Config config;
+
+    ASSERT_FALSE(config.isLoaded());
+
+    config.load();
+
+    ASSERT_TRUE(config.isLoaded());
+    ASSERT_EQ(config.get<int>("db.port"), 1996);
+
+    ASSERT_NO_THROW(config.load());
+}
+
+TEST_F(ConfigTest, loadAsync_loadsConfigOnBackgroundThread)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    Config config;
+
+    auto loaded = config.loadAsync();
+
+    // Reads started while loading wait for it
+    ASSERT_EQ(config.get<std::string>("db.host"), "localhost");
+
+    loaded.get();
+
+    ASSERT_TRUE(config.isLoaded());
+}
+
+TEST_F(ConfigTest, loadAsync_givenNotExistingConfigDirectory_rethrowsFromFuture)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", (testConfigDirectory / "missing").string());
+
+    Config config;
+
+    auto loaded = config.loadAsync();
+
+    ASSERT_THROW(loaded.get(), std::runtime_error);
+    ASSERT_FALSE(config.isLoaded());
+    ASSERT_THROW(config.load(), std::runtime_error);
+}
+
+TEST_F(ConfigTest, givenManyFiles_mergesParsedFilesInPrecedenceOrder)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    for (int index = 0; index < 12; ++index)
+    {
+        const auto name = "extra-" + std::to_string(10 + index);
+
+        if (index % 3 == 0)
+        {
+            std::ofstream{testConfigDirectory / (name + ".json")}
+                << R"({"shared": {"value": )" << index << R"(}, ")" << name << R"(": )" << index << "}";
+        }
+        else if (index % 3 == 1)
+        {
+            std::ofstream{testConfigDirectory / (name + ".yaml")}
+                << "shared:\n    value: " << index << "\n" << name << ": " << index << "\n";
+        }
+        else
+        {
+            std::ofstream{testConfigDirectory / (name + ".xml")} << "<configuration><shared><value>" << index
+                                                                << "</value></shared><" << name << ">" << index
+                                                                << "</" << name << "></configuration>";
+        }
+    }
+
+    for (const auto* loadThreads : {"1", "4"})
+    {
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_LOAD_THREADS", loadThreads);
+
+        Config config;
+
+        // Files outside the environment order are merged alphabetically after test.json overrides default.json
+        ASSERT_EQ(config.get<int>("shared.value"), 11);
+        ASSERT_EQ(config.get<int>("extra-10"), 0);
+        ASSERT_EQ(config.get<int>("extra-21"), 11);
+        ASSERT_EQ(config.get<int>("db.port"), 1996);
+        ASSERT_EQ(config.get<std::string>("aws.region"), "eu-west-1");
+    }
+
+    std::ofstream{testConfigDirectory / "extra-15.json"} << "{invalid";
+
+    ASSERT_THROW(Config{}.load(), std::runtime_error);
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_LOAD_THREADS", "");
+}
+
+TEST_F(ConfigTest, givenEnvPrefix_overridesKeysFromPrefixedVariables)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+    EnvironmentSetter::setEnvironmentVariable("APP__DB__PORT", "5432");
+    EnvironmentSetter::setEnvironmentVariable("APP__AUTH__EXPIRESIN", "60");
+    EnvironmentSetter::setEnvironmentVariable("APP__FEATURES__NEW_SEARCH", "true");
+
+    ASSERT_EQ(Config{}.get<int>("db.port"), 1996);
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "APP");
+
+    {
+        Config config;
+
+        // Overrides take the type of the value they replace, new keys hold the variable as a string
+        EXPECT_EQ(config.get<int>("db.port"), 5432);
+        EXPECT_EQ(config.get<int>("auth.expiresIn"), 60);
+        EXPECT_EQ(config.get<std::string>("features.new_search"), "true");
+        EXPECT_FALSE(config.has("auth.expiresin"));
+    }
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__DB__PORT", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__AUTH__EXPIRESIN", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__FEATURES__NEW_SEARCH", "");
+}
+
+TEST_F(ConfigTest, givenEnvPrefix_parsesOverridesOfArraysAsCommaSeparatedLists)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "APP");
+    EnvironmentSetter::setEnvironmentVariable("APP__AUTH__ROLES", "ops");
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS", "5,6,7");
+
+    std::ofstream{localConfigFilePath} << R"({"server": {"ports": [80, 443]}})";
+
+    {
+        Config config;
+
+        EXPECT_EQ(config.get<std::vector<std::string>>("auth.roles"), (std::vector<std::string>{"ops"}));
+        EXPECT_EQ(config.get<std::vector<int>>("server.ports"), (std::vector<int>{5, 6, 7}));
+    }
+
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS", "5,http");
+
+    EXPECT_THROW(Config{}.get<int>("db.port"), std::runtime_error);
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__AUTH__ROLES", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS", "");
+}
+
+TEST_F(ConfigTest, givenEnvPrefix_givenKeysDifferingOnlyByCase_throws)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "APP");
+    EnvironmentSetter::setEnvironmentVariable("APP__DB__PORT", "5432");
+
+    std::ofstream{localConfigFilePath} << R"({"db": {"Host": "db-1"}})";
+
+    ASSERT_EQ(Config{}.get<int>("db.port"), 5432);
+
+    EnvironmentSetter::setEnvironmentVariable("APP__DB__HOST", "db-2");
+
+    try
+    {
+        Config{}.get<int>("db.port");
+        FAIL() << "Expected std::runtime_error";
+    }
+    catch (const std::runtime_error& error)
+    {
+        ASSERT_NE(std::string{error.what()}.find("matches configuration keys 'db.Host' and 'db.host'"),
+                  std::string::npos);
+    }
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__DB__PORT", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__DB__HOST", "");
+}
+
+TEST_F(ConfigTest, givenIndexedOverridesOfArrayElements_writesThemIntoTheArray)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+    EnvironmentSetter::setEnvironmentVariable("ROLE_A", "ops");
+    EnvironmentSetter::setEnvironmentVariable("APP__AUTH__ROLES__2", "auditor");
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS__0", "8080");
+
+    std::ofstream{customEnvironmentsConfigFilePath}
+        << R"({"auth": {"roles": ["ROLE_A", "ROLE_B"]}, "server": {"hosts": ["H0", "H1", "H2", "H3", "H4", "H5"]}})";
+    std::ofstream{localConfigFilePath} << R"({"server": {"ports": [80, 443], "hosts": ["alpha"]}})";
+
+    for (const auto* name : {"H1", "H2", "H3", "H4", "H5", "APP__SERVER__PORTS__2", "APP__SERVER__PORTS__3"})
+    {
+        EnvironmentSetter::setEnvironmentVariable(name, "1");
+    }
+
+    {
+        Config config;
+
+        // ROLE_B is not set and keeps the element of the config file
+        EXPECT_EQ(config.get<std::vector<std::string>>("auth.roles"), (std::vector<std::string>{"ops", "user"}));
+        // Elements past the end are appended in index order, whatever order the variables are stored in
+        EXPECT_EQ(config.get<std::vector<std::string>>("server.hosts"),
+                  (std::vector<std::string>{"alpha", "1", "1", "1", "1", "1"}));
+        EXPECT_EQ(config.get<std::string>("auth.roles[0]"), "ops");
+    }
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "APP");
+
+    {
+        Config config;
+
+        EXPECT_EQ(config.get<std::vector<std::string>>("auth.roles"),
+                  (std::vector<std::string>{"ops", "user", "auditor"}));
+        EXPECT_EQ(config.get<std::vector<int>>("server.ports"), (std::vector<int>{8080, 443, 1, 1}));
+    }
+
+    for (const auto* name : {"H1", "H2", "H3", "H4", "H5", "APP__SERVER__PORTS__2", "APP__SERVER__PORTS__3"})
+    {
+        EnvironmentSetter::setEnvironmentVariable(name, "");
+    }
+
+    // Elements must parse into the element type and be at most one past the end of the array
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS__0", "http");
+
+    EXPECT_THROW(Config{}.get<int>("db.port"), std::runtime_error);
+
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS__0", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS__5", "8080");
+
+    EXPECT_THROW(Config{}.get<int>("db.port"), std::runtime_error);
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__SERVER__PORTS__5", "");
+    EnvironmentSetter::setEnvironmentVariable("APP__AUTH__ROLES__2", "");
+    EnvironmentSetter::setEnvironmentVariable("ROLE_A", "");
+}
+
+TEST_F(ConfigTest, givenMappedStringSize_readsLargeXmlStringsFromTheFile)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_MAPPED_STRING_SIZE", "32");
+
+    const std::string certificate(4096, 'c');
+    const std::string banner(64, 'b');
+
+    std::ofstream{testConfigDirectory / "default.xml"}
+        << "<configuration><tls><certificate>" << certificate << "</certificate><banner>" << banner
+        << "</banner></tls></configuration>";
+    std::ofstream{localConfigFilePath} << R"({"tls": {"banner": ""}})";
+
+    {
+        Config config;
+
+        // Values of later files replace borrowed strings, even an empty one
+        EXPECT_EQ(config.get<std::string>("tls.certificate"), certificate);
+        EXPECT_EQ(config.get<std::string>("tls.banner"), "");
+        EXPECT_EQ(config.get<int>("db.port"), 1996);
+    }
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_MAPPED_STRING_SIZE", "");
+}
+
+TEST_F(ConfigTest, givenCacheDirectory_loadsUnchangedFilesWithoutParsingThem)
+{
+    const auto cacheDirectory = testConfigDirectory.parent_path() / "testConfigCache";
+    std::filesystem::remove_all(cacheDirectory);
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_CACHE_DIR", cacheDirectory.string());
+
+    const auto expectedPort = Config{}.get<int>("db.port");
+
+    ASSERT_FALSE(std::filesystem::is_empty(cacheDirectory));
+
+    // Same size and modification time, a config that parsed the file again would fail on its contents
+    const auto modificationTime = std::filesystem::last_write_time(localConfigFilePath);
+    const auto fileSize = std::filesystem::file_size(localConfigFilePath);
+    std::ofstream{localConfigFilePath} << std::string(fileSize, '{');
+    std::filesystem::last_write_time(localConfigFilePath, modificationTime);
+
+    EXPECT_EQ(Config{}.get<int>("db.port"), expectedPort);
+
+    std::filesystem::last_write_time(localConfigFilePath, modificationTime + std::chrono::seconds{1});
+
+    EXPECT_THROW(Config{}.get<int>("db.port"), std::runtime_error);
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_CACHE_DIR", "");
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+TEST_F(ConfigTest, givenMemoryResource_allocatesValuesFromIt)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
+
+    std::array<std::byte, 64 * 1024> buffer;
+    std::pmr::monotonic_buffer_resource memoryResource{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+    Config config{&memoryResource};
+
+    ASSERT_EQ(config.get<std::string>("db.host"), "localhost");
+    ASSERT_EQ(config.get<int>("db.port"), 1996);
+    ASSERT_EQ(config.get<std::vector<std::string>>("auth.roles"), (std::vector<std::string>{"admin", "user"}));
+}
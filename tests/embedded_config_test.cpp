@@ -0,0 +1,153 @@
+#include "config-cxx/config.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "config-cxx-embedded/testEmbeddedConfig.h"
+#include "embedded_config_generator.h"
+#include "environment_setter.h"
+#include "file_system_service.h"
+
+using namespace ::testing;
+using namespace config;
+using namespace config::embedded;
+using namespace config::filesystem;
+using namespace config::tests;
+
+namespace
+{
+const auto projectRootPath = FileSystemService::getExecutablePath();
+const auto embeddedConfigTestDirectory = projectRootPath.parent_path() / "embeddedConfigTest";
+
+// The embedded table is generated at build time from tests/embedded_config for CXX_ENV=production
+static_assert(testEmbeddedConfig.find("db.port")->number == 5432);
+static_assert(testEmbeddedConfig.find("db.host")->text == "db.production");
+static_assert(testEmbeddedConfig.find("db.user") == nullptr);
+
+class EmbeddedConfigTest : public Test
+{
+public:
+    void SetUp() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_EMBED_TEST_DB_PASSWORD", "secret");
+
+        std::filesystem::remove_all(embeddedConfigTestDirectory);
+        std::filesystem::create_directory(embeddedConfigTestDirectory);
+    }
+
+    void TearDown() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_EMBED_TEST_DB_PASSWORD", "");
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "");
+        EnvironmentSetter::setEnvironmentVariable("EMBEDTEST__DB__PORT", "");
+        EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_EMBED_TEST_ROLE_0", "");
+        EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_EMBED_TEST_ROLE_2", "");
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", "");
+        EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "");
+
+        std::filesystem::remove_all(embeddedConfigTestDirectory);
+    }
+};
+
+TEST_F(EmbeddedConfigTest, givenNoOverrides_readsEmbeddedValuesOnly)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", "/not/existing/config/directory");
+
+    Config config{testEmbeddedConfig};
+
+    ASSERT_EQ(config.get<std::string>("db.host"), "db.production");
+    ASSERT_EQ(config.get<int>("db.port"), 5432);
+    ASSERT_EQ(config.get<double>("db.timeout"), 2.5);
+    ASSERT_TRUE(config.get<bool>("db.ssl"));
+    ASSERT_EQ(config.get<std::vector<std::string>>("auth.roles"), (std::vector<std::string>{"admin", "user"}));
+    ASSERT_EQ(config.get<std::vector<int>>("server.ports"), (std::vector<int>{80, 443}));
+    ASSERT_EQ(config.get<std::vector<double>>("server.weights"), (std::vector<double>{0.5, 1.5}));
+    ASSERT_EQ(config.get<std::vector<bool>>("server.flags"), (std::vector<bool>{true, false}));
+    ASSERT_EQ(config.size("servers"), 2);
+    ASSERT_EQ(config.get<int>("servers[1].port"), 8081);
+    ASSERT_EQ(config.get<std::string>("messages.greeting"), "Say \"caf\u00e9\"\n\tto C:\\config");
+    ASSERT_FALSE(config.has("db.password"));
+}
+
+TEST_F(EmbeddedConfigTest, givenEnvironmentOverrides_appliesMappedAndPrefixedVariables)
+{
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "EMBEDTEST");
+    EnvironmentSetter::setEnvironmentVariable("EMBEDTEST__DB__PORT", "6543");
+
+    Config config{testEmbeddedConfig, EmbeddedOverrides::Environment};
+
+    ASSERT_EQ(config.get<std::string>("db.password"), "secret");
+    ASSERT_EQ(config.get<int>("db.port"), 6543);
+    ASSERT_EQ(config.get<std::string>("db.host"), "db.production");
+}
+
+TEST_F(EmbeddedConfigTest, givenMappedArray_writesVariablesIntoItsElements)
+{
+    EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_EMBED_TEST_ROLE_0", "ops");
+    EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_EMBED_TEST_ROLE_2", "auditor");
+
+    Config config{testEmbeddedConfig, EmbeddedOverrides::Environment};
+
+    // The unset variable of the second element keeps the embedded element, the third one appends
+    ASSERT_EQ(config.get<std::vector<std::string>>("auth.roles"),
+              (std::vector<std::string>{"ops", "user", "auditor"}));
+}
+
+TEST_F(EmbeddedConfigTest, givenFileOverrides_loadsConfigDirectoryOverEmbeddedValues)
+{
+    std::ofstream{embeddedConfigTestDirectory / "local.json"} << R"({"db": {"host": "db.local"}})";
+
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", embeddedConfigTestDirectory.string());
+    EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "production");
+
+    Config config{testEmbeddedConfig, EmbeddedOverrides::FilesAndEnvironment};
+
+    ASSERT_EQ(config.get<std::string>("db.host"), "db.local");
+    ASSERT_EQ(config.get<int>("db.port"), 5432);
+    ASSERT_EQ(config.get<std::string>("db.password"), "secret");
+}
+
+TEST_F(EmbeddedConfigTest, generate_givenConfigDirectory_writesSortedEntriesAndVariableNames)
+{
+    std::ofstream{embeddedConfigTestDirectory / "default.json"} << R"({"db": {"port": 1996, "host": "localhost"}})";
+    std::ofstream{embeddedConfigTestDirectory / "custom-environment-variables.json"}
+        << R"({"db": {"host": "DB_HOST"}, "auth": {"roles": ["ROLE_0", "ROLE_1", "ROLE_2", "ROLE_3", "ROLE_4", )"
+           R"("ROLE_5", "ROLE_6", "ROLE_7", "ROLE_8", "ROLE_9", "ROLE_10"]}})";
+
+    const auto header = EmbeddedConfigGenerator::generate(embeddedConfigTestDirectory, "development", "appConfig");
+
+    const auto hostEntry = header.find(R"({.key = "db.host"sv, .type = EmbeddedType::String, .number = 0, )"
+                                       R"(.text = "localhost"sv, .numbers = {}, .texts = {}})");
+    const auto portEntry = header.find(R"({.key = "db.port"sv, .type = EmbeddedType::Int, .number = 1996, )"
+                                       R"(.text = {}, .numbers = {}, .texts = {}})");
+
+    ASSERT_NE(hostEntry, std::string::npos);
+    ASSERT_NE(portEntry, std::string::npos);
+    ASSERT_LT(hostEntry, portEntry);
+    ASSERT_NE(header.find(R"({.key = "db.host"sv, .variableName = "DB_HOST"sv})"), std::string::npos);
+
+    // Elements of a mapped array are applied in index order
+    const auto secondRole = header.find(R"({.key = "auth.roles.2"sv, .variableName = "ROLE_2"sv})");
+    const auto lastRole = header.find(R"({.key = "auth.roles.10"sv, .variableName = "ROLE_10"sv})");
+
+    ASSERT_NE(secondRole, std::string::npos);
+    ASSERT_NE(lastRole, std::string::npos);
+    ASSERT_LT(secondRole, lastRole);
+    ASSERT_NE(header.find("inline constexpr EmbeddedConfig appConfig{"), std::string::npos);
+}
+
+TEST_F(EmbeddedConfigTest, generate_givenInvalidNameOrVariable_throws)
+{
+    std::ofstream{embeddedConfigTestDirectory / "custom-environment-variables.json"} << R"({"db": {"port": 5432}})";
+
+    ASSERT_THROW(EmbeddedConfigGenerator::generate(embeddedConfigTestDirectory, "development", "app-config"),
+                 std::runtime_error);
+    ASSERT_THROW(EmbeddedConfigGenerator::generate(embeddedConfigTestDirectory, "development", "appConfig"),
+                 std::runtime_error);
+}
+}
@@ -140,3 +140,43 @@ TEST_F(FileSystemServiceTest, isRelative_withRootPath_returnsFalse)
     
     ASSERT_FALSE(FileSystemService::isRelative(rootPath));
 }
+
+TEST_F(FileSystemServiceTest, mappedFile_givenModifiedContents_doesNotWriteThemBack)
+{
+    {
+        MappedFile mappedFile{testReadingFilePath};
+
+        ASSERT_EQ(std::string(mappedFile.data(), mappedFile.size()), "example data");
+
+        mappedFile.data()[0] = 'E';
+
+        ASSERT_EQ(std::string(mappedFile.data(), mappedFile.size()), "Example data");
+    }
+
+    ASSERT_EQ(FileSystemService::read(testReadingFilePath), "example data");
+}
+
+TEST_F(FileSystemServiceTest, mappedFile_givenIncorrectPath_shouldThrowException)
+{
+    ASSERT_THROW(MappedFile{invalidPath}, std::runtime_error);
+}
+
+TEST_F(FileSystemServiceTest, writePrivateFile_createsFileAndDirectoriesOnlyTheOwnerCanAccess)
+{
+    const auto privateDirectoryPath = filesystemTestDirectoryPath / "private" / "cache";
+    const auto privateFilePath = privateDirectoryPath / "values.bin";
+
+    FileSystemService::createPrivateDirectories(privateDirectoryPath);
+    FileSystemService::writePrivateFile(privateFilePath, "secret");
+
+    ASSERT_EQ(FileSystemService::read(privateFilePath), "secret");
+    ASSERT_THROW(FileSystemService::writePrivateFile(privateFilePath, "other"), std::runtime_error);
+    ASSERT_EQ(FileSystemService::read(privateFilePath), "secret");
+#ifndef _WIN32
+    using std::filesystem::perms;
+
+    ASSERT_EQ(std::filesystem::status(privateFilePath).permissions(), perms::owner_read | perms::owner_write);
+    ASSERT_EQ(std::filesystem::status(privateDirectoryPath).permissions(), perms::owner_all);
+    ASSERT_EQ(std::filesystem::status(privateDirectoryPath.parent_path()).permissions(), perms::owner_all);
+#endif
+}
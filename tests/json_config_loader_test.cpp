@@ -20,7 +20,8 @@ using namespace config::filesystem;
 
 namespace
 {
-using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>>;
+using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>,
+                                 std::vector<int>, std::vector<double>, std::vector<bool>>;
 
 const auto projectRootPath = FileSystemService::getExecutablePath();
 const auto testConfigDirectory = projectRootPath.parent_path() / "testConfig";
@@ -111,11 +112,11 @@ TEST_F(JsonConfigLoaderTest, loadConfigFile)
     EnvironmentSetter::setEnvironmentVariable("CXX_ENV", "test");
     EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_DIR", testConfigDirectory.string());
 
-    std::unordered_map<std::string, ConfigValue> expectedValues = {{"db.port", 1996},
-                                                                   {"auth.expiresIn", 3600},
-                                                                   {"auth.enabled", true},
-                                                                   {"auth.roles.0", "admin"},
-                                                                   {"auth.roles.1", "user"}};
+    std::unordered_map<std::string, ConfigValue> expectedValues = {
+        {"db.port", 1996},
+        {"auth.expiresIn", 3600},
+        {"auth.enabled", true},
+        {"auth.roles", std::vector<std::string>{"admin", "user"}}};
 
     std::unordered_map<std::string, ConfigValue> configValues;
     JsonConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
@@ -242,6 +243,56 @@ TEST_F(JsonConfigLoaderTest, loadConfigFile_withDeeplyNestedStructure_handlesCor
     ASSERT_EQ(std::get<std::string>(configValues["level1.level2.level3.level4.value"]), "deep");
 }
 
+TEST_F(JsonConfigLoaderTest, loadConfigFile_givenMixedArraysAndEmptyContainers_flattensLikeDocument)
+{
+    const std::string mixedJson = R"({
+        "ratios": [0.5, 1.5],
+        "servers": [{"host": "a", "port": 80}, {"host": "b", "port": 81}],
+        "mixed": [1, 2.5, "x", {"nested": true}, [3], [], {}],
+        "emptyObject": {},
+        "emptyArray": []
+    })";
+
+    const auto mixedPath = testConfigDirectory / "mixed.json";
+    std::ofstream file{mixedPath};
+    file << mixedJson;
+    file.close();
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    JsonConfigLoader::loadConfigFile(mixedPath, configValues);
+
+    ASSERT_EQ(std::get<std::vector<double>>(configValues["ratios"]), (std::vector<double>{0.5, 1.5}));
+    ASSERT_EQ(std::get<std::string>(configValues["servers.0.host"]), "a");
+    ASSERT_EQ(std::get<int>(configValues["servers.1.port"]), 81);
+    ASSERT_EQ(std::get<int>(configValues["mixed.0"]), 1);
+    ASSERT_EQ(std::get<float>(configValues["mixed.1"]), 2.5f);
+    ASSERT_EQ(std::get<std::string>(configValues["mixed.2"]), "x");
+    ASSERT_TRUE(std::get<bool>(configValues["mixed.3.nested"]));
+    ASSERT_EQ(std::get<std::vector<int>>(configValues["mixed.4"]), (std::vector<int>{3}));
+    ASSERT_TRUE(std::holds_alternative<std::nullptr_t>(configValues["emptyObject"]));
+    ASSERT_TRUE(std::get<std::vector<std::string>>(configValues["emptyArray"]).empty());
+    // Elements are visited one by one once an array holds an array, empty ones stay arrays
+    ASSERT_TRUE(std::get<std::vector<std::string>>(configValues["mixed.5"]).empty());
+    ASSERT_TRUE(std::holds_alternative<std::nullptr_t>(configValues["mixed.6"]));
+    ASSERT_EQ(configValues.count("servers"), 0);
+    ASSERT_EQ(configValues.count("mixed"), 0);
+}
+
+TEST_F(JsonConfigLoaderTest, loadConfigEnvFile_givenEmptyContainers_mapsNoVariables)
+{
+    EnvironmentSetter::setEnvironmentVariable("AWS_ACCOUNT_ID", "9999999999");
+
+    std::ofstream{customEnvironmentsConfigFilePath}
+        << R"({"aws": {"accountId": "AWS_ACCOUNT_ID", "roles": [], "tags": {}, "regions": [[], "AWS_ACCOUNT_ID"]}})";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    JsonConfigLoader::loadConfigEnvFile(customEnvironmentsConfigFilePath, configValues);
+
+    ASSERT_EQ(configValues["aws.accountId"], ConfigValue{"9999999999"});
+    ASSERT_EQ(configValues["aws.regions.1"], ConfigValue{"9999999999"});
+    ASSERT_EQ(configValues.size(), 2u);
+}
+
 TEST_F(JsonConfigLoaderTest, loadConfigFile_whenFileDoesNotExist_doesNotThrow)
 {
     const auto nonExistentPath = testConfigDirectory / "nonexistent.json";
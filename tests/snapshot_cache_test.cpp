@@ -0,0 +1,141 @@
+#include "snapshot_cache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "config_provider.h"
+#include "config_store.h"
+#include "environment_setter.h"
+#include "file_system_service.h"
+
+using namespace ::testing;
+using namespace config;
+using namespace config::environment;
+using namespace config::filesystem;
+using namespace config::tests;
+
+namespace
+{
+const auto projectRootPath = FileSystemService::getExecutablePath();
+const auto snapshotCacheTestDirectory = projectRootPath.parent_path() / "snapshotCacheTest";
+const auto configDirectory = snapshotCacheTestDirectory / "config";
+const auto cacheDirectory = snapshotCacheTestDirectory / "cache";
+const auto defaultConfigFilePath = configDirectory / "default.json";
+const auto customEnvironmentsConfigFilePath = configDirectory / "custom-environment-variables.json";
+
+class SnapshotCacheTest : public Test
+{
+public:
+    void SetUp() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_CACHE_TEST_KEY", "secret");
+
+        std::filesystem::remove_all(snapshotCacheTestDirectory);
+        std::filesystem::create_directories(configDirectory);
+
+        std::ofstream{defaultConfigFilePath} << R"({"db": {"port": 1996}})";
+        std::ofstream{customEnvironmentsConfigFilePath} << R"({"api": {"key": "CONFIG_CXX_CACHE_TEST_KEY"}})";
+    }
+
+    void TearDown() override
+    {
+        EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_CACHE_TEST_KEY", "");
+        EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "");
+        EnvironmentSetter::setEnvironmentVariable("CACHETEST__DB__PORT", "");
+
+        std::filesystem::remove_all(snapshotCacheTestDirectory);
+    }
+
+    static SnapshotCache createCache()
+    {
+        return SnapshotCache{cacheDirectory, configDirectory, "test",
+                             {defaultConfigFilePath, customEnvironmentsConfigFilePath}};
+    }
+
+    static void storeCache(std::unordered_map<std::string, ConfigValue> values)
+    {
+        const ConfigStore configStore{std::move(values)};
+
+        createCache().store(configStore, {"CONFIG_CXX_CACHE_TEST_KEY"}, EnvironmentSnapshot::capture());
+    }
+
+    static std::shared_ptr<const ConfigStore> loadCache()
+    {
+        return createCache().load(EnvironmentSnapshot::capture(), std::pmr::get_default_resource());
+    }
+};
+
+TEST_F(SnapshotCacheTest, load_givenUnchangedFilesAndEnvironment_returnsStoredValues)
+{
+    storeCache({{"db.port", 1996}, {"api.key", "secret"}});
+
+    const auto configStore = loadCache();
+
+    ASSERT_TRUE(configStore);
+    ASSERT_EQ(configStore->find("db.port")->asInt(), 1996);
+    ASSERT_EQ(configStore->find("api.key")->asString(), "secret");
+}
+
+TEST_F(SnapshotCacheTest, load_givenChangedConfigFile_returnsNothing)
+{
+    storeCache({{"db.port", 1996}});
+
+    std::ofstream{defaultConfigFilePath, std::ios::app} << "\n";
+
+    ASSERT_FALSE(loadCache());
+}
+
+TEST_F(SnapshotCacheTest, load_givenOtherEnvironment_returnsNothing)
+{
+    storeCache({{"db.port", 1996}});
+
+    ASSERT_FALSE(SnapshotCache(cacheDirectory, configDirectory, "production", {defaultConfigFilePath})
+                     .load(EnvironmentSnapshot::capture(), std::pmr::get_default_resource()));
+
+    EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_CACHE_TEST_KEY", "rotated");
+
+    ASSERT_FALSE(loadCache());
+
+    EnvironmentSetter::setEnvironmentVariable("CONFIG_CXX_CACHE_TEST_KEY", "secret");
+
+    ASSERT_TRUE(loadCache());
+
+    // Prefixed overrides may add keys, so every variable with the prefix is part of the cached environment
+    EnvironmentSetter::setEnvironmentVariable("CXX_CONFIG_ENV_PREFIX", "CACHETEST");
+    storeCache({{"db.port", 1996}});
+    EnvironmentSetter::setEnvironmentVariable("CACHETEST__DB__PORT", "5432");
+
+    ASSERT_FALSE(loadCache());
+}
+
+TEST_F(SnapshotCacheTest, load_givenTruncatedCache_returnsNothing)
+{
+    storeCache({{"db.host", "localhost"}, {"auth.roles", std::vector<std::string>{"admin", "user"}}});
+
+    const auto cacheFilePath = createCache().getFilePath();
+    std::filesystem::resize_file(cacheFilePath, std::filesystem::file_size(cacheFilePath) - 3);
+
+    ASSERT_FALSE(loadCache());
+}
+
+TEST_F(SnapshotCacheTest, store_givenCacheFileCannotBeReplaced_removesTemporaryFile)
+{
+    // A file cannot be renamed over a directory that is not empty
+    const auto cacheFilePath = createCache().getFilePath();
+    std::filesystem::create_directories(cacheFilePath / "blocked");
+
+    ASSERT_THROW(storeCache({{"api.key", "secret"}}), std::runtime_error);
+
+    for (const auto& entry : std::filesystem::directory_iterator{cacheFilePath.parent_path()})
+    {
+        EXPECT_EQ(entry.path(), cacheFilePath);
+    }
+}
+}
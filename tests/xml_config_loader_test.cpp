@@ -9,6 +9,8 @@
 
 #include "gtest/gtest.h"
 
+#include "config_provider.h"
+#include "config_value.h"
 #include "file_system_service.h"
 #include "environment_setter.h"
 
@@ -19,7 +21,8 @@ using namespace config::filesystem;
 
 namespace
 {
-using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>>;
+using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>,
+                                 std::vector<int>, std::vector<double>, std::vector<bool>>;
 
 const auto projectRootPath = FileSystemService::getExecutablePath();
 const auto testConfigDirectory = projectRootPath.parent_path() / "testConfig";
@@ -167,4 +170,191 @@ TEST_F(XmlConfigLoaderTest, loadConfigFileWithInvalidXml)
     ASSERT_THROW(XmlConfigLoader::loadConfigFile(invalidConfigFilePath, configValues), std::runtime_error);
 }
 
+TEST_F(XmlConfigLoaderTest, loadConfigFile_givenRepeatedNumericElements_storesTypedList)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+<configuration>
+    <server>
+        <port>8080</port>
+        <port>8081</port>
+    </server>
+    <weights>
+        <weight>0.5</weight>
+        <weight>2</weight>
+    </weights>
+</configuration>
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    XmlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
+
+    EXPECT_EQ(configValues["server"], (ConfigValue{std::vector<int>{8080, 8081}}));
+    EXPECT_EQ(configValues["weights"], (ConfigValue{std::vector<double>{0.5, 2.0}}));
+}
+
+
+TEST_F(XmlConfigLoaderTest, loadConfigFile_givenRepeatedElementsWithChildren_storesElementsByIndex)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+<configuration>
+    <servers>
+        <server>
+            <host>alpha</host>
+            <port>8080</port>
+        </server>
+        <server>
+            <host>beta</host>
+            <port>9090</port>
+        </server>
+    </servers>
+</configuration>
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    XmlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
+
+    EXPECT_EQ(configValues.size(), 4u);
+    EXPECT_EQ(configValues["servers.0.host"], ConfigValue{"alpha"});
+    EXPECT_EQ(configValues["servers.0.port"], ConfigValue{8080});
+    EXPECT_EQ(configValues["servers.1.host"], ConfigValue{"beta"});
+    EXPECT_EQ(configValues["servers.1.port"], ConfigValue{9090});
+}
+
+TEST_F(XmlConfigLoaderTest, loadConfigFile_givenListsNextToOtherElements_keepsTheirElementNames)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+<configuration>
+    <a><x>1</x></a>
+    <a><x>2</x></a>
+    <b><x>3</x></b>
+    <b><x>4</x></b>
+    <cluster>
+        <port>80</port>
+        <port>443</port>
+        <name>main</name>
+    </cluster>
+</configuration>
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    XmlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
+
+    EXPECT_EQ(configValues.size(), 6u);
+    EXPECT_EQ(configValues["a.0.x"], ConfigValue{1});
+    EXPECT_EQ(configValues["a.1.x"], ConfigValue{2});
+    EXPECT_EQ(configValues["b.0.x"], ConfigValue{3});
+    EXPECT_EQ(configValues["b.1.x"], ConfigValue{4});
+    EXPECT_EQ(configValues["cluster.port"], (ConfigValue{std::vector<int>{80, 443}}));
+    EXPECT_EQ(configValues["cluster.name"], ConfigValue{"main"});
+}
+
+TEST_F(XmlConfigLoaderTest, loadConfigFile_givenKeyDefinedTwice_throws)
+{
+    // Element names may contain dots, so both elements define "db.port"
+    std::ofstream{testEnvConfigFilePath} << R"(
+<configuration>
+    <db><port>1</port></db>
+    <db.port>2</db.port>
+</configuration>
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+
+    ASSERT_THROW(XmlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues), std::runtime_error);
+}
+
+TEST_F(XmlConfigLoaderTest, loadConfigFile_givenNumericLookingValues_typesThemLikeStandardConversions)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+<configuration>
+    <padded> 42</padded>
+    <signed>+7</signed>
+    <ratio>-2.5</ratio>
+    <exponent>1e5</exponent>
+    <version>1.2.3</version>
+    <escaped>a &amp; b</escaped>
+    <empty></empty>
+</configuration>
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    XmlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
+
+    EXPECT_EQ(configValues["padded"], ConfigValue{42});
+    EXPECT_EQ(configValues["signed"], ConfigValue{7});
+    EXPECT_EQ(configValues["ratio"], ConfigValue{-2.5f});
+    EXPECT_EQ(configValues["exponent"], ConfigValue{"1e5"});
+    EXPECT_EQ(configValues["version"], ConfigValue{"1.2.3"});
+    EXPECT_EQ(configValues["escaped"], ConfigValue{"a & b"});
+    EXPECT_EQ(configValues.count("empty"), 0u);
+}
+
+TEST_F(XmlConfigLoaderTest, loadConfigFile_givenBorrowedStrings_leavesLargeStringsInMappedFile)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+<configuration>
+    <tls>
+        <certificate>-----BEGIN CERTIFICATE-----
+MIIBszCCAVmgAwIBAgIUB &amp; more
+-----END CERTIFICATE-----</certificate>
+        <ratio>1234567.890123456</ratio>
+        <name>short</name>
+    </tls>
+</configuration>
+)";
+
+    BorrowedStrings borrowedStrings;
+    borrowedStrings.minSize = 16;
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    XmlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues, borrowedStrings);
+
+    const std::string certificate =
+        "-----BEGIN CERTIFICATE-----\nMIIBszCCAVmgAwIBAgIUB & more\n-----END CERTIFICATE-----";
+
+    // Values a parser copies out of the file are never borrowed, with pugixml parsing in place the certificate is
+    if (borrowedStrings.values.empty())
+    {
+        EXPECT_TRUE(borrowedStrings.owners.empty());
+        EXPECT_EQ(configValues["tls.certificate"], ConfigValue{certificate});
+    }
+    else
+    {
+        ASSERT_EQ(borrowedStrings.values.size(), 1u);
+        ASSERT_EQ(borrowedStrings.owners.size(), 1u);
+        EXPECT_EQ(borrowedStrings.values["tls.certificate"], certificate);
+        EXPECT_EQ(configValues["tls.certificate"], ConfigValue{""});
+    }
+
+    // Only strings are borrowed, numbers of the same length are still typed
+    EXPECT_EQ(configValues["tls.ratio"], ConfigValue{1234567.890123456f});
+    EXPECT_EQ(configValues["tls.name"], ConfigValue{"short"});
+}
+
+TEST_F(XmlConfigLoaderTest, loadConfigEnvFile_givenEarlierValues_resolvesOnlyMappedKeys)
+{
+    EnvironmentSetter::setEnvironmentVariable("AWS_ACCOUNT_ID", "9999999999");
+
+    // Values of earlier layers are left alone, even a value that names an environment variable
+    std::unordered_map<std::string, ConfigValue> configValues;
+    for (int index = 0; index < 100; ++index)
+    {
+        configValues["defaults.value" + std::to_string(index)] = "value" + std::to_string(index);
+    }
+    configValues["defaults.accountId"] = "AWS_ACCOUNT_ID";
+
+    const auto environment = environment::EnvironmentSnapshot::capture();
+    XmlConfigLoader::loadConfigEnvFile(customEnvironmentsConfigFilePath, configValues, environment);
+
+    EXPECT_EQ(configValues["aws.accountId"], ConfigValue{"9999999999"});
+    EXPECT_EQ(configValues.count("aws.accountKey"), 0u);
+    EXPECT_EQ(configValues["defaults.accountId"], ConfigValue{"AWS_ACCOUNT_ID"});
+    EXPECT_EQ(configValues.size(), 102u);
+
+    for (int index = 0; index < 100; ++index)
+    {
+        EXPECT_EQ(configValues["defaults.value" + std::to_string(index)], ConfigValue{"value" + std::to_string(index)});
+    }
+}
+
 } // anonymous namespace
@@ -9,6 +9,7 @@
 
 #include "gtest/gtest.h"
 
+#include "config_provider.h"
 #include "file_system_service.h"
 #include "environment_setter.h"
 #include "yaml-cpp/yaml.h"
@@ -20,7 +21,8 @@ using namespace config::filesystem;
 
 namespace
 {
-using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>>;
+using ConfigValue = std::variant<std::nullptr_t, bool, int, double, std::string, float, std::vector<std::string>,
+                                 std::vector<int>, std::vector<double>, std::vector<bool>>;
 
 const auto projectRootPath = FileSystemService::getExecutablePath();
 const auto testConfigDirectory = projectRootPath.parent_path() / "testConfig";
@@ -273,4 +275,101 @@ values:
     ASSERT_EQ(std::get<std::string>(configValues["name"]), "test");
 }
 
+TEST_F(YamlConfigLoaderTest, loadConfigFile_givenScalarSequences_storesTypedArrays)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+ports: [8080, 8081]
+weights: [0.5, 2]
+flags: [true, false]
+mixed: [1, two]
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    YamlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
+
+    EXPECT_EQ(configValues["ports"], (ConfigValue{std::vector<int>{8080, 8081}}));
+    EXPECT_EQ(configValues["weights"], (ConfigValue{std::vector<double>{0.5, 2.0}}));
+    EXPECT_EQ(configValues["flags"], (ConfigValue{std::vector<bool>{true, false}}));
+    EXPECT_EQ(configValues["mixed"], (ConfigValue{std::vector<std::string>{"1", "two"}}));
+}
+
+
+TEST_F(YamlConfigLoaderTest, loadConfigFile_givenSequenceOfMaps_storesElementsByIndex)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+servers:
+    - host: alpha
+      port: 8080
+    - host: beta
+      ports: [9090, 9091]
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    YamlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
+
+    EXPECT_EQ(configValues.size(), 4u);
+    EXPECT_EQ(configValues["servers.0.host"], ConfigValue{"alpha"});
+    EXPECT_EQ(configValues["servers.0.port"], ConfigValue{8080});
+    EXPECT_EQ(configValues["servers.1.host"], ConfigValue{"beta"});
+    EXPECT_EQ(configValues["servers.1.ports"], (ConfigValue{std::vector<int>{9090, 9091}}));
+}
+
+TEST_F(YamlConfigLoaderTest, loadConfigFile_givenAnchorsAndAmbiguousScalars_storesValuesLikeNodeTree)
+{
+    std::ofstream{testEnvConfigFilePath} << R"(
+defaults: &defaults
+    timeout: 30
+    hosts: [a, b]
+primary: *defaults
+mixed: [1, ~, 3]
+octal: 010
+whole: "1.0"
+big: 3000000000
+flag: Yes
+word: tRUE
+empty: ~
+)";
+
+    std::unordered_map<std::string, ConfigValue> configValues;
+    YamlConfigLoader::loadConfigFile(testEnvConfigFilePath, configValues);
+
+    EXPECT_EQ(configValues["primary.timeout"], ConfigValue{30});
+    EXPECT_EQ(configValues["primary.hosts"], (ConfigValue{std::vector<std::string>{"a", "b"}}));
+    EXPECT_EQ(configValues["mixed.0"], ConfigValue{1});
+    EXPECT_EQ(configValues["mixed.2"], ConfigValue{3});
+    EXPECT_EQ(configValues.count("mixed.1"), 0u);
+    EXPECT_EQ(configValues["octal"], ConfigValue{8});
+    EXPECT_EQ(configValues["whole"], ConfigValue{"1.0"});
+    EXPECT_EQ(configValues["big"], ConfigValue{3000000000.0});
+    EXPECT_EQ(configValues["flag"], ConfigValue{true});
+    EXPECT_EQ(configValues["word"], ConfigValue{"tRUE"});
+    EXPECT_EQ(configValues.count("empty"), 0u);
+}
+
+TEST_F(YamlConfigLoaderTest, loadConfigEnvFile_givenEarlierValues_resolvesOnlyMappedKeys)
+{
+    EnvironmentSetter::setEnvironmentVariable("AWS_ACCOUNT_ID", "9999999999");
+
+    // Values of earlier layers are left alone, even a value that names an environment variable
+    std::unordered_map<std::string, ConfigValue> configValues;
+    for (int index = 0; index < 100; ++index)
+    {
+        configValues["defaults.value" + std::to_string(index)] = "value" + std::to_string(index);
+    }
+    configValues["defaults.accountId"] = "AWS_ACCOUNT_ID";
+
+    const auto environment = environment::EnvironmentSnapshot::capture();
+    YamlConfigLoader::loadConfigEnvFile(customEnvironmentsConfigFilePath, configValues, environment);
+
+    EXPECT_EQ(configValues["aws.accountId"], ConfigValue{"9999999999"});
+    EXPECT_EQ(configValues.count("aws.accountKey"), 0u);
+    EXPECT_EQ(configValues["defaults.accountId"], ConfigValue{"AWS_ACCOUNT_ID"});
+    EXPECT_EQ(configValues.size(), 102u);
+
+    for (int index = 0; index < 100; ++index)
+    {
+        EXPECT_EQ(configValues["defaults.value" + std::to_string(index)], ConfigValue{"value" + std::to_string(index)});
+    }
+}
+
 }
@@ -0,0 +1,40 @@
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "config_struct_generator.h"
+
+// Writes the header of a typed config struct, run by the config_cxx_struct() CMake function
+int main(int argc, char* argv[])
+{
+    if (argc != 5)
+    {
+        std::cerr << "Usage: config-cxx-struct <schema file> <struct name> <namespace> <output header>" << std::endl;
+        return 2;
+    }
+
+    try
+    {
+        const auto header = config::ConfigStructGenerator::generate(argv[1], argv[2], argv[3]);
+        const std::filesystem::path outputPath{argv[4]};
+
+        std::filesystem::create_directories(outputPath.parent_path());
+
+        std::ofstream output{outputPath, std::ios::binary | std::ios::trunc};
+
+        if (!output.write(header.data(), static_cast<std::streamsize>(header.size())))
+        {
+            std::cerr << "config-cxx-struct: failed to write " << outputPath.string() << std::endl;
+            return 1;
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "config-cxx-struct: " << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}